@@ -0,0 +1,53 @@
+#include <yngine/mcts.hpp>
+
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <thread>
+
+// Measures search speed with different board cache setups from a position after
+//   the ring placement, usage: board_cache [memory limit in MB] [seconds per search]
+int main(int argc, const char** argv) {
+    const std::size_t memory_limit_mb = argc > 1 ? std::stoull(argv[1]) : 1024;
+    const float search_seconds = argc > 2 ? std::stof(argv[2]) : 10.0f;
+    const int thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    // Same random position for all configurations
+    XoshiroCpp::Xoshiro256StarStar prng{4242};
+    Yngine::BoardState board_state;
+    for (int ply = 0; ply < 20 && board_state.get_next_action() != Yngine::NextAction::Done; ply++) {
+        Yngine::MoveList move_list;
+        board_state.generate_moves(move_list);
+        board_state.apply_move(move_list.get_random(prng));
+    }
+
+    struct Config {
+        const char* name;
+        Yngine::BoardCacheOptions options;
+    };
+
+    const Config configs[] = {
+        {"no cache",                   {0,                 0,  0}},
+        {"16 MB, depth 4",             {16 * 1024 * 1024,  4,  32}},
+        {"16 MB, depth 8",             {16 * 1024 * 1024,  8,  32}},
+        {"64 MB, depth 12",            {64 * 1024 * 1024,  12, 32}},
+        {"64 MB, depth 16",            {64 * 1024 * 1024,  16, 8}},
+    };
+
+    for (const auto& config : configs) {
+        Yngine::MCTS mcts{memory_limit_mb * 1024 * 1024};
+        mcts.set_board(board_state);
+        mcts.set_board_cache(config.options);
+
+        mcts.search(search_seconds, thread_count).get();
+        const auto info = mcts.get_search_info();
+
+        std::cout
+            << config.name
+            << ": iterations/s = " << info.iterations_per_second
+            << ", cache memory (MB) = " << (info.board_cache_bytes / 1024 / 1024)
+            << std::endl;
+    }
+
+    return 0;
+}
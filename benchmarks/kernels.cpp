@@ -0,0 +1,449 @@
+#include <yngine/mcts.hpp>
+#include <yngine/perf_counters.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <limits>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Keeps the compiler from optimizing away a result that isn't used otherwise
+template<typename T>
+static void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Kernel {
+    std::string name;
+    // Performs the given number of operations
+    std::function<void(uint64_t)> run;
+    // Hardware counters only count the calling thread, so they mean nothing for
+    //   kernels that do their work on other threads
+    bool runs_on_calling_thread = true;
+};
+
+struct KernelResult {
+    std::string name;
+    uint64_t iterations;
+    double nanoseconds_per_operation;
+    // CPU time of the whole process, so it includes the other threads of parallel kernels
+    double cpu_nanoseconds_per_operation;
+    // Empty if the counters aren't available
+    std::optional<Yngine::PerfCounterValues> counters;
+};
+
+struct KernelTiming {
+    double seconds;
+    double cpu_seconds;
+};
+
+static KernelTiming time_kernel(const Kernel& kernel, uint64_t iterations, Yngine::PerfCounterGroup& counters) {
+    counters.start();
+    const auto start = std::chrono::steady_clock::now();
+    const auto cpu_start = std::clock();
+    kernel.run(iterations);
+    const auto cpu_end = std::clock();
+    const auto end = std::chrono::steady_clock::now();
+    counters.stop();
+
+    return KernelTiming{
+        .seconds = std::chrono::duration<double>(end - start).count(),
+        .cpu_seconds = static_cast<double>(cpu_end - cpu_start) / CLOCKS_PER_SEC,
+    };
+}
+
+// Grows the number of iterations until a run takes the minimum time,
+//   then reports the fastest of a few runs of that length
+static KernelResult measure_kernel(const Kernel& kernel, double min_seconds, int repetitions, Yngine::PerfCounterGroup& counters) {
+    uint64_t iterations = 1;
+    auto timing = time_kernel(kernel, iterations, counters);
+
+    while (timing.seconds < min_seconds) {
+        const double scale = timing.seconds > 0.0 ? std::min(10.0, 1.2 * min_seconds / timing.seconds) : 10.0;
+        iterations = std::max<uint64_t>(iterations + 1, iterations * scale);
+        timing = time_kernel(kernel, iterations, counters);
+    }
+
+    auto best_counters = counters.read();
+    for (int repetition = 1; repetition < repetitions; repetition++) {
+        const auto repetition_timing = time_kernel(kernel, iterations, counters);
+
+        if (repetition_timing.seconds < timing.seconds) {
+            timing = repetition_timing;
+            best_counters = counters.read();
+        }
+    }
+
+    return KernelResult{
+        .name = kernel.name,
+        .iterations = iterations,
+        .nanoseconds_per_operation = timing.seconds * 1e9 / iterations,
+        .cpu_nanoseconds_per_operation = timing.cpu_seconds * 1e9 / iterations,
+        .counters = counters.is_available() && kernel.runs_on_calling_thread
+            ? std::optional{best_counters} : std::nullopt,
+    };
+}
+
+// Counters per operation and instructions per cycle, in the order of COUNTER_COLUMNS
+static std::vector<double> counter_columns(const KernelResult& result) {
+    const auto& counters = *result.counters;
+    const double cycles = counters.get(Yngine::PerfCounter::Cycles);
+
+    return {
+        cycles > 0.0 ? counters.get(Yngine::PerfCounter::Instructions) / cycles : 0.0,
+        static_cast<double>(counters.get(Yngine::PerfCounter::L1DataMisses)) / result.iterations,
+        static_cast<double>(counters.get(Yngine::PerfCounter::LastLevelCacheMisses)) / result.iterations,
+        static_cast<double>(counters.get(Yngine::PerfCounter::BranchMisses)) / result.iterations,
+    };
+}
+
+static const char* const COUNTER_COLUMNS[] = {
+    "ipc",
+    "l1d_misses_per_op",
+    "llc_misses_per_op",
+    "branch_misses_per_op",
+};
+
+// Fixed positions of every phase of the game, collected from seeded random playouts
+struct PositionSets {
+    static constexpr std::size_t POSITIONS_PER_PHASE = 512;
+
+    std::vector<Yngine::BoardState> phases[4];
+};
+
+static PositionSets collect_positions() {
+    PositionSets sets;
+    XoshiroCpp::Xoshiro256StarStar prng{1234};
+
+    const auto is_full = [&] {
+        return std::all_of(std::begin(sets.phases), std::end(sets.phases), [](const auto& positions) {
+            return positions.size() >= PositionSets::POSITIONS_PER_PHASE;
+        });
+    };
+
+    while (!is_full()) {
+        Yngine::BoardState board_state;
+
+        while (board_state.get_next_action() != Yngine::NextAction::Done) {
+            auto& positions = sets.phases[static_cast<int>(board_state.get_next_action())];
+            if (positions.size() < PositionSets::POSITIONS_PER_PHASE) {
+                positions.push_back(board_state);
+            }
+
+            Yngine::MoveList move_list;
+            board_state.generate_moves(move_list);
+            board_state.apply_move(move_list.get_random(prng));
+        }
+    }
+
+    return sets;
+}
+
+static const char* phase_name(Yngine::NextAction phase) {
+    switch (phase) {
+    case Yngine::NextAction::RingPlacement:
+        return "ring_placement";
+    case Yngine::NextAction::RingMovement:
+        return "ring_movement";
+    case Yngine::NextAction::RowRemoval:
+        return "row_removal";
+    case Yngine::NextAction::RingRemoval:
+        return "ring_removal";
+    default:
+        abort();
+    }
+}
+
+static void add_bitboard_kernels(std::vector<Kernel>& kernels, const PositionSets& sets) {
+    // Scans of empty bitboards aren't defined, so early positions without markers are left out
+    std::vector<Yngine::Bitboard> bitboards;
+    for (const auto& board_state : sets.phases[static_cast<int>(Yngine::NextAction::RingMovement)]) {
+        for (const auto color : {Yngine::Color::White, Yngine::Color::Black}) {
+            if (board_state.get_markers(color)) {
+                bitboards.push_back(board_state.get_markers(color));
+            }
+        }
+    }
+
+    const auto for_each_bitboard = [bitboards](auto operation) {
+        return [bitboards, operation](uint64_t iterations) {
+            for (uint64_t iteration = 0; iteration < iterations; iteration++) {
+                operation(bitboards[iteration % bitboards.size()]);
+            }
+        };
+    };
+
+    kernels.push_back({"bitboard/bit_scan", for_each_bitboard([](Yngine::Bitboard bitboard) {
+        do_not_optimize(bitboard.bit_scan());
+    })});
+
+    kernels.push_back({"bitboard/bit_scan_reverse", for_each_bitboard([](Yngine::Bitboard bitboard) {
+        do_not_optimize(bitboard.bit_scan_reverse());
+    })});
+
+    kernels.push_back({"bitboard/popcount", for_each_bitboard([](Yngine::Bitboard bitboard) {
+        do_not_optimize(bitboard.popcount());
+    })});
+
+    kernels.push_back({"bitboard/scan_all_bits", for_each_bitboard([](Yngine::Bitboard bitboard) {
+        while (bitboard) {
+            do_not_optimize(bitboard.bit_scan_and_reset());
+        }
+    })});
+
+    kernels.push_back({"bitboard/shift_all_directions", for_each_bitboard([](Yngine::Bitboard bitboard) {
+        for (uint8_t direction = 0; direction < 6; direction++) {
+            auto shifted = bitboard;
+            shifted.shift_in_direction(static_cast<Yngine::Direction>(direction));
+            do_not_optimize(shifted);
+        }
+    })});
+}
+
+static void add_board_state_kernels(std::vector<Kernel>& kernels, const PositionSets& sets) {
+    for (int phase = 0; phase < 4; phase++) {
+        const auto& positions = sets.phases[phase];
+        const std::string name = phase_name(static_cast<Yngine::NextAction>(phase));
+
+        kernels.push_back({"generate_moves/" + name, [positions](uint64_t iterations) {
+            for (uint64_t iteration = 0; iteration < iterations; iteration++) {
+                Yngine::MoveList move_list;
+                positions[iteration % positions.size()].generate_moves(move_list);
+                do_not_optimize(move_list);
+            }
+        }});
+
+        // Every phase has its own move type, all moves of the positions are applied
+        std::vector<std::pair<Yngine::BoardState, Yngine::Move>> moves;
+        for (const auto& board_state : positions) {
+            Yngine::MoveList move_list;
+            board_state.generate_moves(move_list);
+
+            for (std::size_t move_index = 0; move_index < move_list.get_size(); move_index++) {
+                moves.push_back({board_state, move_list[move_index]});
+            }
+        }
+
+        kernels.push_back({"apply_move/" + name, [moves](uint64_t iterations) {
+            for (uint64_t iteration = 0; iteration < iterations; iteration++) {
+                const auto& [board_state, move] = moves[iteration % moves.size()];
+                do_not_optimize(board_state.with_move(move));
+            }
+        }});
+    }
+
+    // Row checks of the positions right after every ring move
+    std::vector<std::pair<Yngine::BoardState, Yngine::RingMove>> ring_moves;
+    for (const auto& board_state : sets.phases[static_cast<int>(Yngine::NextAction::RingMovement)]) {
+        Yngine::MoveList move_list;
+        board_state.generate_moves(move_list);
+
+        for (std::size_t move_index = 0; move_index < move_list.get_size(); move_index++) {
+            if (const auto* ring_move = std::get_if<Yngine::RingMove>(&move_list[move_index])) {
+                ring_moves.push_back({board_state.with_move(*ring_move), *ring_move});
+            }
+        }
+    }
+
+    kernels.push_back({"check_rows", [ring_moves](uint64_t iterations) {
+        for (uint64_t iteration = 0; iteration < iterations; iteration++) {
+            const auto& [board_state, ring_move] = ring_moves[iteration % ring_moves.size()];
+            do_not_optimize(board_state.check_rows(ring_move));
+        }
+    }});
+}
+
+// Selection of the child with the greatest UCT the same way the search does it,
+//   one operation is one pass over all children
+static void add_uct_kernels(std::vector<Kernel>& kernels) {
+    for (const int child_count : {8, 32, 128}) {
+        auto pool = std::make_shared<Yngine::PoolAllocator<Yngine::MCTSNode>>(1024 * 1024, Yngine::ArenaOptions{.huge_pages = Yngine::HugePages::None});
+        XoshiroCpp::Xoshiro256StarStar prng{static_cast<uint64_t>(child_count)};
+
+        auto* parent = pool->allocate(Yngine::PassMove{}, Yngine::POOL_NULL_INDEX, Yngine::Color::White);
+
+        Yngine::MCTSNode* previous = nullptr;
+        uint32_t parent_simulations = 0;
+        for (int child_index = 0; child_index < child_count; child_index++) {
+            auto* child = pool->allocate(Yngine::PassMove{}, pool->index_of(parent), Yngine::Color::Black);
+
+            const uint32_t simulations = 1 + prng() % 1000;
+            child->add_half_wins_and_simulations(prng() % (2 * simulations + 1), simulations);
+            parent_simulations += simulations;
+
+            if (previous) {
+                previous->next_sibling = pool->index_of(child);
+            } else {
+                parent->first_child = pool->index_of(child);
+            }
+            previous = child;
+        }
+
+        kernels.push_back({"compute_uct/" + std::to_string(child_count) + "_children", [pool, parent, parent_simulations](uint64_t iterations) {
+            for (uint64_t iteration = 0; iteration < iterations; iteration++) {
+                float greatest_uct = -std::numeric_limits<float>::infinity();
+                Yngine::MCTSNode* greatest_uct_node = nullptr;
+
+                for (auto* child = pool->get(parent->first_child); child; child = pool->get(child->next_sibling)) {
+                    const auto uct = child->compute_uct(parent_simulations);
+                    if (uct > greatest_uct) {
+                        greatest_uct = uct;
+                        greatest_uct_node = child;
+                    }
+                }
+
+                do_not_optimize(greatest_uct_node);
+            }
+        }});
+    }
+}
+
+// Every thread allocates and frees nodes through its own local cache, as the search does,
+//   one operation is one allocation and one free on each of the threads
+static void add_pool_kernels(std::vector<Kernel>& kernels, int max_threads) {
+    constexpr int LIVE_NODES = 256;
+
+    for (int thread_count = 1; thread_count <= max_threads; thread_count *= 2) {
+        auto pool = std::make_shared<Yngine::PoolAllocator<Yngine::MCTSNode>>(64 * 1024 * 1024, Yngine::ArenaOptions{.huge_pages = Yngine::HugePages::None});
+
+        kernels.push_back({"pool_allocator/" + std::to_string(thread_count) + "_threads", [pool, thread_count](uint64_t iterations) {
+            const auto worker = [&pool, iterations] {
+                Yngine::PoolAllocator<Yngine::MCTSNode>::LocalCache cache{*pool};
+                Yngine::MCTSNode* nodes[LIVE_NODES];
+
+                for (int node_index = 0; node_index < LIVE_NODES; node_index++) {
+                    nodes[node_index] = cache.allocate(Yngine::PassMove{}, Yngine::POOL_NULL_INDEX, Yngine::Color::White);
+                }
+
+                for (uint64_t iteration = 0; iteration < iterations; iteration++) {
+                    auto*& node = nodes[iteration % LIVE_NODES];
+                    cache.free(node);
+                    node = cache.allocate(Yngine::PassMove{}, Yngine::POOL_NULL_INDEX, Yngine::Color::White);
+                    do_not_optimize(node);
+                }
+
+                for (auto* node : nodes) {
+                    cache.free(node);
+                }
+            };
+
+            std::vector<std::thread> threads;
+            for (int thread_index = 0; thread_index < thread_count; thread_index++) {
+                threads.push_back(std::thread{worker});
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }, false});
+
+        // The shared free list without local caches, every allocation and free is a CAS
+        kernels.push_back({"pool_allocator_shared/" + std::to_string(thread_count) + "_threads", [pool, thread_count](uint64_t iterations) {
+            const auto worker = [&pool, iterations] {
+                for (uint64_t iteration = 0; iteration < iterations; iteration++) {
+                    auto* node = pool->allocate(Yngine::PassMove{}, Yngine::POOL_NULL_INDEX, Yngine::Color::White);
+                    do_not_optimize(node);
+                    pool->free(node);
+                }
+            };
+
+            std::vector<std::thread> threads;
+            for (int thread_index = 0; thread_index < thread_count; thread_index++) {
+                threads.push_back(std::thread{worker});
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }, false});
+    }
+}
+
+// Measures the time per operation of the small building blocks of the search separately,
+//   so a regression can be traced to one of them.
+//   usage: kernels [json|csv] [name filter] [minimum seconds per kernel]
+int main(int argc, const char** argv) {
+    const std::string format = argc > 1 ? argv[1] : "csv";
+    const std::string filter = argc > 2 ? argv[2] : "";
+    const double min_seconds = argc > 3 ? std::stod(argv[3]) : 0.2;
+    const int max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (format != "json" && format != "csv") {
+        std::cerr << "Expected json or csv as the output format" << std::endl;
+        return 1;
+    }
+
+    const auto sets = collect_positions();
+
+    std::vector<Kernel> kernels;
+    add_bitboard_kernels(kernels, sets);
+    add_board_state_kernels(kernels, sets);
+    add_uct_kernels(kernels);
+    add_pool_kernels(kernels, max_threads);
+
+    // Without permission for the counters they are left out of the output
+    Yngine::PerfCounterGroup counters;
+
+    std::vector<KernelResult> results;
+    for (const auto& kernel : kernels) {
+        if (kernel.name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        results.push_back(measure_kernel(kernel, min_seconds, 3, counters));
+    }
+
+    // The JSON has the layout of Google Benchmark output, so its comparison scripts work on it
+    if (format == "json") {
+        std::cout << "{\n  \"context\": {\"num_cpus\": " << max_threads << "},\n  \"benchmarks\": [\n";
+        for (std::size_t result_index = 0; result_index < results.size(); result_index++) {
+            const auto& result = results[result_index];
+            std::cout
+                << "    {\"name\": \"" << result.name << "\""
+                << ", \"run_type\": \"iteration\""
+                << ", \"iterations\": " << result.iterations
+                << ", \"real_time\": " << result.nanoseconds_per_operation
+                << ", \"cpu_time\": " << result.cpu_nanoseconds_per_operation
+                << ", \"time_unit\": \"ns\"";
+
+            if (result.counters) {
+                const auto columns = counter_columns(result);
+                for (std::size_t column_index = 0; column_index < columns.size(); column_index++) {
+                    std::cout << ", \"" << COUNTER_COLUMNS[column_index] << "\": " << columns[column_index];
+                }
+            }
+
+            std::cout << "}" << (result_index + 1 < results.size() ? ",\n" : "\n");
+        }
+        std::cout << "  ]\n}" << std::endl;
+    } else {
+        std::cout << "name,iterations,ns_per_op,cpu_ns_per_op";
+        for (const auto* column : COUNTER_COLUMNS) {
+            std::cout << "," << column;
+        }
+        std::cout << std::endl;
+
+        for (const auto& result : results) {
+            std::cout << result.name << "," << result.iterations << "," << result.nanoseconds_per_operation << "," << result.cpu_nanoseconds_per_operation;
+
+            // Empty fields for kernels without counters
+            const auto columns = result.counters ? counter_columns(result) : std::vector<double>{};
+            for (std::size_t column_index = 0; column_index < std::size(COUNTER_COLUMNS); column_index++) {
+                std::cout << ",";
+                if (result.counters) {
+                    std::cout << columns[column_index];
+                }
+            }
+
+            std::cout << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <yngine/mcts.hpp>
+
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <thread>
+
+// Measures search speed with different arena page setups on a big tree,
+//   usage: search_memory [memory limit in MB] [seconds per search]
+int main(int argc, const char** argv) {
+    const std::size_t memory_limit_mb = argc > 1 ? std::stoull(argv[1]) : 4096;
+    const float search_seconds = argc > 2 ? std::stof(argv[2]) : 30.0f;
+    const int thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    struct Config {
+        const char* name;
+        Yngine::ArenaOptions options;
+    };
+
+    const Config configs[] = {
+        {"regular pages",            {Yngine::HugePages::None,        false, false}},
+        {"regular pages, prefault",  {Yngine::HugePages::None,        true,  false}},
+        {"transparent huge pages",   {Yngine::HugePages::Transparent, false, false}},
+        {"transparent, prefault",    {Yngine::HugePages::Transparent, true,  false}},
+        {"explicit huge pages",      {Yngine::HugePages::Explicit,    false, false}},
+    };
+
+    for (const auto& config : configs) {
+        const auto create_start = std::chrono::steady_clock::now();
+        Yngine::MCTS mcts{memory_limit_mb * 1024 * 1024, config.options};
+        const std::chrono::duration<double> create_time = std::chrono::steady_clock::now() - create_start;
+
+        const auto search_start = std::chrono::steady_clock::now();
+        mcts.search(search_seconds, thread_count).get();
+        const std::chrono::duration<double> search_time = std::chrono::steady_clock::now() - search_start;
+
+        const auto iterations = mcts.get_root()->get_half_wins_and_simulations().second;
+
+        std::cout
+            << config.name
+            << ": iterations/s = " << (iterations / search_time.count())
+            << ", creation (s) = " << create_time.count()
+            << ", huge pages = " << (mcts.uses_huge_pages() ? "yes" : "no")
+            << std::endl;
+    }
+
+    return 0;
+}
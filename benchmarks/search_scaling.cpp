@@ -0,0 +1,198 @@
+#include <yngine/mcts.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Positions of the ring movement phase, the same on every run
+static std::vector<Yngine::BoardState> create_position_suite() {
+    constexpr int POSITION_COUNT = 8;
+
+    std::vector<Yngine::BoardState> positions;
+    for (uint64_t seed = 1; positions.size() < POSITION_COUNT; seed++) {
+        XoshiroCpp::Xoshiro256StarStar prng{seed};
+        Yngine::BoardState board_state;
+
+        // Ring placement takes 10 plies, the rest are moves of the middle game
+        const int plies = 20 + seed % 3 * 5;
+        for (int ply = 0; ply < plies && board_state.get_next_action() != Yngine::NextAction::Done; ply++) {
+            Yngine::MoveList move_list;
+            board_state.generate_moves(move_list);
+            board_state.apply_move(move_list.get_random(prng));
+        }
+
+        if (board_state.get_next_action() == Yngine::NextAction::RingMovement) {
+            positions.push_back(board_state);
+        }
+    }
+
+    return positions;
+}
+
+struct RunResult {
+    float iterations_per_second;
+    float bytes_per_iteration;
+    float agreement;
+    Yngine::SearchStats search_stats;
+};
+
+// Searches every position of the suite with a new tree, so the results don't depend on the order
+static RunResult run_suite(const std::vector<Yngine::BoardState>& positions, const std::vector<Yngine::Move>& reference_moves, Yngine::SearchLimit limit, int thread_count, std::size_t memory_limit_bytes, Yngine::TraceRecorder* trace_recorder) {
+    uint64_t iterations = 0;
+    uint64_t pool_bytes = 0;
+    double seconds = 0.0;
+    int agreeing = 0;
+    Yngine::SearchStats search_stats{};
+
+    for (std::size_t position_index = 0; position_index < positions.size(); position_index++) {
+        Yngine::MCTS mcts{memory_limit_bytes};
+        mcts.set_board(positions[position_index]);
+        mcts.set_trace_recorder(trace_recorder);
+
+        const auto move = mcts.search(limit, thread_count).get();
+        const auto info = mcts.get_search_info();
+
+        iterations += info.iterations;
+        pool_bytes += info.pool_used_bytes;
+        seconds += info.elapsed_seconds;
+        agreeing += !reference_moves.empty() && move == reference_moves[position_index];
+        search_stats.merge(info.search_stats);
+    }
+
+    return RunResult{
+        .iterations_per_second = static_cast<float>(iterations / seconds),
+        .bytes_per_iteration = static_cast<float>(pool_bytes) / iterations,
+        .agreement = static_cast<float>(agreeing) / positions.size(),
+        .search_stats = search_stats,
+    };
+}
+
+// Share of the iteration time and average ticks of every phase, and the event counts
+static void print_search_stats(const Yngine::SearchStats& search_stats) {
+    uint64_t total_ticks = 0;
+    for (const auto ticks : search_stats.phase_ticks) {
+        total_ticks += ticks;
+    }
+
+    std::cout << "   ";
+    for (std::size_t phase_index = 0; phase_index < Yngine::SEARCH_PHASE_COUNT; phase_index++) {
+        const auto ticks = search_stats.phase_ticks[phase_index];
+        const auto calls = search_stats.phase_calls[phase_index];
+
+        std::cout
+            << " " << Yngine::SearchStats::phase_name(static_cast<Yngine::SearchPhase>(phase_index))
+            << " = " << (total_ticks > 0 ? 100.0 * ticks / total_ticks : 0.0) << "%"
+            << " (" << (calls > 0 ? ticks / calls : 0) << " ticks)";
+    }
+
+    for (std::size_t event_index = 0; event_index < Yngine::SEARCH_EVENT_COUNT; event_index++) {
+        std::cout
+            << ", " << Yngine::SearchStats::event_name(static_cast<Yngine::SearchEvent>(event_index))
+            << " = " << search_stats.events[event_index];
+    }
+
+    std::cout << std::endl;
+
+    if constexpr (!Yngine::SEARCH_PERF_COUNTERS_ENABLED) {
+        return;
+    }
+
+    // Hardware counters per iteration, zero where the kernel didn't permit them
+    const auto iterations = std::max<uint64_t>(1, search_stats.phase_calls[static_cast<std::size_t>(Yngine::SearchPhase::Select)]);
+
+    std::cout << "   ";
+    for (std::size_t phase_index = 0; phase_index < Yngine::SEARCH_PHASE_COUNT; phase_index++) {
+        const auto& counters = search_stats.phase_counters[phase_index];
+        const double cycles = counters.get(Yngine::PerfCounter::Cycles);
+
+        std::cout
+            << " " << Yngine::SearchStats::phase_name(static_cast<Yngine::SearchPhase>(phase_index))
+            << ": IPC = " << (cycles > 0.0 ? counters.get(Yngine::PerfCounter::Instructions) / cycles : 0.0)
+            << ", L1D misses = " << static_cast<double>(counters.get(Yngine::PerfCounter::L1DataMisses)) / iterations
+            << ", LLC misses = " << static_cast<double>(counters.get(Yngine::PerfCounter::LastLevelCacheMisses)) / iterations
+            << ", branch misses = " << static_cast<double>(counters.get(Yngine::PerfCounter::BranchMisses)) / iterations
+            << ";";
+    }
+
+    std::cout << std::endl;
+}
+
+// Measures how the search speed grows with the number of threads on a suite of positions,
+//   with a fixed number of iterations and with a fixed time per search. The agreement is
+//   how often the searched move is the move of a single threaded search with more iterations.
+//   With a trace file the events of the searches are written to it, the latest ones if there are too many.
+//   usage: search_scaling [iterations] [seconds] [max threads] [memory limit in MB] [trace file]
+int main(int argc, const char** argv) {
+    const int iterations = argc > 1 ? std::stoi(argv[1]) : 200'000;
+    const float search_seconds = argc > 2 ? std::stof(argv[2]) : 2.0f;
+    const int max_threads = argc > 3 ? std::stoi(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t memory_limit_bytes = (argc > 4 ? std::stoull(argv[4]) : 1024) * 1024 * 1024;
+    const std::string trace_file_path = argc > 5 ? argv[5] : "";
+
+    std::unique_ptr<Yngine::TraceRecorder> trace_recorder;
+    if (!trace_file_path.empty()) {
+        trace_recorder = std::make_unique<Yngine::TraceRecorder>();
+    }
+
+    std::vector<int> thread_counts;
+    for (int thread_count = 1; thread_count < max_threads; thread_count *= 2) {
+        thread_counts.push_back(thread_count);
+    }
+    thread_counts.push_back(max_threads);
+
+    const auto positions = create_position_suite();
+
+    std::vector<Yngine::Move> reference_moves;
+    for (const auto& board_state : positions) {
+        Yngine::MCTS mcts{memory_limit_bytes};
+        mcts.set_board(board_state);
+        reference_moves.push_back(mcts.search(4 * iterations, 1).get());
+    }
+
+    struct Mode {
+        const char* name;
+        Yngine::SearchLimit limit;
+    };
+
+    const Mode modes[] = {
+        {"fixed iterations", iterations},
+        {"fixed time",       search_seconds},
+    };
+
+    for (const auto& mode : modes) {
+        float single_thread_speed = 0.0f;
+
+        for (const int thread_count : thread_counts) {
+            const auto result = run_suite(positions, reference_moves, mode.limit, thread_count, memory_limit_bytes, trace_recorder.get());
+
+            if (thread_count == 1) {
+                single_thread_speed = result.iterations_per_second;
+            }
+
+            const float efficiency = result.iterations_per_second / (single_thread_speed * thread_count);
+
+            std::cout
+                << mode.name
+                << ", threads = " << thread_count
+                << ": iterations/s = " << result.iterations_per_second
+                << ", efficiency = " << efficiency
+                << ", pool bytes/iteration = " << result.bytes_per_iteration
+                << ", agreement = " << result.agreement
+                << std::endl;
+
+            if constexpr (Yngine::SEARCH_STATS_ENABLED) {
+                print_search_stats(result.search_stats);
+            }
+        }
+    }
+
+    if (trace_recorder && !trace_recorder->write_json(trace_file_path)) {
+        std::cerr << "Failed to write " << trace_file_path << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
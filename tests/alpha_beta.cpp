@@ -0,0 +1,141 @@
+#include <yngine/alpha_beta.hpp>
+#include <yngine/evaluation.hpp>
+#include <XoshiroCpp.hpp>
+
+#include "check.hpp"
+
+#include <iostream>
+#include <vector>
+
+// Walks every window of 5 nodes along the SE, NE and N axes node by node
+static Yngine::RowThreats count_row_threats_naive(Yngine::Bitboard markers, Yngine::Bitboard other_markers) {
+    constexpr int AXIS_STEPS[3][2] = {{1, 0}, {0, 1}, {-1, 1}};
+
+    Yngine::RowThreats threats{0, 0};
+
+    for (int y = 0; y < 11; y++) {
+        for (int x = 0; x < 11; x++) {
+            for (const auto& step : AXIS_STEPS) {
+                int own = 0;
+                bool is_open = true;
+
+                for (int k = 0; k < 5; k++) {
+                    const int node_x = x + k * step[0];
+                    const int node_y = y + k * step[1];
+
+                    if (node_x < 0 || node_x >= 11 || node_y >= 11 || !Yngine::Bitboard::are_coords_in_game(node_x, node_y)) {
+                        is_open = false;
+                        break;
+                    }
+
+                    const auto index = Yngine::Bitboard::coords_to_index(node_x, node_y);
+                    own += markers.get_bit(index);
+                    is_open &= !other_markers.get_bit(index);
+                }
+
+                if (is_open) {
+                    threats.threes += own == 3;
+                    threats.fours += own == 4;
+                }
+            }
+        }
+    }
+
+    return threats;
+}
+
+// Random markers of both colors with different densities, so the boards have many windows of every count
+static void check_row_threats() {
+    XoshiroCpp::Xoshiro256StarStar prng{1337};
+
+    for (int board_index = 0; board_index < 2000; board_index++) {
+        const uint64_t own_density = 1 + board_index % 7;
+        const uint64_t other_density = board_index % 3;
+
+        Yngine::Bitboard markers;
+        Yngine::Bitboard other_markers;
+
+        for (uint8_t index = 0; index < 11*11; index++) {
+            if (!Yngine::Bitboard::is_index_in_game(index)) {
+                continue;
+            }
+
+            const uint64_t roll = prng() % 16;
+            if (roll < own_density) {
+                markers.set_bit(index);
+            } else if (roll < own_density + other_density) {
+                other_markers.set_bit(index);
+            }
+        }
+
+        const auto threats = Yngine::count_row_threats(markers, other_markers);
+        const auto expected = count_row_threats_naive(markers, other_markers);
+
+        check(threats.threes == expected.threes, "threes differ from the naive count");
+        check(threats.fours == expected.fours, "fours differ from the naive count");
+    }
+}
+
+// Whether the move wins at once, by making a row the player removes together with a third
+//   ring, or by ending the game with the last marker while they removed more rings
+static bool is_winning_move(const Yngine::BoardState& board_state, Yngine::Move move) {
+    const auto color = board_state.whose_move();
+    const auto next_board_state = board_state.with_move(move);
+
+    if (next_board_state.get_next_action() == Yngine::NextAction::Done) {
+        const auto winner = color == Yngine::Color::White ? Yngine::GameResult::WhiteWon : Yngine::GameResult::BlackWon;
+        return next_board_state.game_result() == winner;
+    }
+
+    return next_board_state.get_next_action() == Yngine::NextAction::RowRemoval && next_board_state.whose_move() == color;
+}
+
+// Ring movement positions where the player to move already removed two rings and can win
+static std::vector<Yngine::BoardState> collect_winning_positions(std::size_t count) {
+    XoshiroCpp::Xoshiro256StarStar prng{42};
+    std::vector<Yngine::BoardState> positions;
+
+    while (positions.size() < count) {
+        Yngine::BoardState board_state;
+
+        while (board_state.get_next_action() != Yngine::NextAction::Done) {
+            Yngine::MoveList move_list;
+            board_state.generate_moves(move_list);
+
+            const auto color = board_state.whose_move();
+            if (board_state.get_next_action() == Yngine::NextAction::RingMovement && board_state.get_rings(color).popcount() == 3) {
+                for (std::size_t move_index = 0; move_index < move_list.get_size(); move_index++) {
+                    if (is_winning_move(board_state, move_list[move_index])) {
+                        positions.push_back(board_state);
+                        break;
+                    }
+                }
+            }
+
+            board_state.apply_move(move_list.get_random(prng));
+        }
+    }
+
+    return positions;
+}
+
+static void check_finds_wins() {
+    for (const auto& board_state : collect_winning_positions(20)) {
+        for (const int thread_count : {1, 2}) {
+            Yngine::AlphaBeta alpha_beta{1024 * 1024};
+            alpha_beta.set_board(board_state);
+
+            const auto move = alpha_beta.search(100'000, thread_count).get();
+
+            check(is_winning_move(board_state, move), "search missed a winning move");
+            check(alpha_beta.get_score() >= Yngine::AlphaBeta::WIN_SCORE_THRESHOLD, "winning move doesn't have a win score");
+        }
+    }
+}
+
+int main() {
+    check_row_threats();
+    check_finds_wins();
+
+    return report_failures("alpha-beta");
+}
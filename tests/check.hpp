@@ -0,0 +1,27 @@
+#ifndef YNGINE_TESTS_CHECK_HPP
+#define YNGINE_TESTS_CHECK_HPP
+
+#include <iostream>
+#include <string_view>
+
+// Failed checks are counted instead of aborting, so a test reports all of them
+inline int failures = 0;
+
+inline void check(bool condition, std::string_view message) {
+    if (!condition) {
+        std::cerr << "Failed: " << message << std::endl;
+        failures++;
+    }
+}
+
+// Returns the exit code of the test
+inline int report_failures(std::string_view name) {
+    if (failures > 0) {
+        std::cerr << "Failed " << name << " checks: " << failures << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+#endif
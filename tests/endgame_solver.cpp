@@ -0,0 +1,186 @@
+#include <yngine/endgame_solver.hpp>
+#include <XoshiroCpp.hpp>
+
+#include "check.hpp"
+
+#include <iostream>
+#include <optional>
+#include <vector>
+
+static int markers_left(const Yngine::BoardState& board_state) {
+    return 51
+        - board_state.get_markers(Yngine::Color::White).popcount()
+        - board_state.get_markers(Yngine::Color::Black).popcount();
+}
+
+static Yngine::GameResult result_for(Yngine::Color color, int value) {
+    if (value == 0) {
+        return Yngine::GameResult::Draw;
+    }
+
+    const auto winner = value > 0 ? color : Yngine::opposite(color);
+    return winner == Yngine::Color::White ? Yngine::GameResult::WhiteWon : Yngine::GameResult::BlackWon;
+}
+
+// Plain alpha-beta to the end of the game without a table, one for a win of the player to move.
+//   Empty if it needs more nodes than are left, removed rows can make the game long
+static std::optional<int> solve_naive(const Yngine::BoardState& board_state, int alpha, int beta, uint64_t& nodes_left) {
+    if (board_state.get_next_action() == Yngine::NextAction::Done) {
+        const auto result = board_state.game_result();
+        if (result == Yngine::GameResult::Draw) {
+            return 0;
+        }
+
+        return result == result_for(board_state.whose_move(), 1) ? 1 : -1;
+    }
+
+    if (nodes_left == 0) {
+        return std::nullopt;
+    }
+    nodes_left--;
+
+    Yngine::MoveList move_list;
+    board_state.generate_moves(move_list);
+
+    const auto color = board_state.whose_move();
+    int best_value = -1;
+
+    for (std::size_t move_index = 0; move_index < move_list.get_size() && best_value < beta; move_index++) {
+        const auto next_board_state = board_state.with_move(move_list[move_index]);
+        const int child_alpha = std::max(alpha, best_value);
+
+        int value;
+        if (next_board_state.whose_move() == color) {
+            const auto child_value = solve_naive(next_board_state, child_alpha, beta, nodes_left);
+            if (!child_value) {
+                return std::nullopt;
+            }
+            value = *child_value;
+        } else {
+            const auto child_value = solve_naive(next_board_state, -beta, -child_alpha, nodes_left);
+            if (!child_value) {
+                return std::nullopt;
+            }
+            value = -*child_value;
+        }
+
+        best_value = std::max(best_value, value);
+    }
+
+    return best_value;
+}
+
+static std::optional<int> solve_naive(const Yngine::BoardState& board_state) {
+    uint64_t nodes_left = 20'000;
+    return solve_naive(board_state, -1, 1, nodes_left);
+}
+
+// Ring movement positions of random games with at most the given number of markers left
+static std::vector<Yngine::BoardState> collect_positions(std::size_t count, int max_markers_left) {
+    XoshiroCpp::Xoshiro256StarStar prng{2024};
+    std::vector<Yngine::BoardState> positions;
+
+    while (positions.size() < count) {
+        Yngine::BoardState board_state;
+
+        while (board_state.get_next_action() != Yngine::NextAction::Done) {
+            if (board_state.get_next_action() == Yngine::NextAction::RingMovement && markers_left(board_state) <= max_markers_left) {
+                positions.push_back(board_state);
+                break;
+            }
+
+            Yngine::MoveList move_list;
+            board_state.generate_moves(move_list);
+            board_state.apply_move(move_list.get_random(prng));
+        }
+    }
+
+    return positions;
+}
+
+// Results of the solver have to match plain minimax, and its moves have to keep them
+static void check_results() {
+    Yngine::EndgameSolver solver{Yngine::EndgameSolverOptions{
+        .table_bytes = 4 * 1024 * 1024,
+        .max_markers_left = 1,
+        .solve_last_rows = false,
+        .max_nodes = 1'000'000,
+    }};
+
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+
+    for (const auto& board_state : collect_positions(300, 1)) {
+        check(solver.is_endgame(board_state), "position with few markers left isn't an endgame");
+
+        // Only positions minimax can finish are compared
+        const auto expected_value = solve_naive(board_state);
+        if (!expected_value) {
+            continue;
+        }
+
+        const auto color = board_state.whose_move();
+        const auto solved = solver.solve(board_state);
+
+        if (!solved.result || !solved.best_move) {
+            check(false, "solver didn't prove an endgame minimax could");
+            continue;
+        }
+
+        check(*solved.result == result_for(color, *expected_value), "solver result differs from minimax");
+
+        const auto next_board_state = board_state.with_move(*solved.best_move);
+        const auto next_value = solve_naive(next_board_state);
+        check(
+            next_value && (next_board_state.whose_move() == color ? *next_value : -*next_value) == *expected_value,
+            "best move of the solver doesn't keep the result"
+        );
+
+        wins += *expected_value > 0;
+        draws += *expected_value == 0;
+        losses += *expected_value < 0;
+    }
+
+    // Draws are the games ending with the last marker while both players removed as many rings
+    check(wins > 0, "no forced wins among the positions");
+    check(draws > 0, "no draws at the marker limit among the positions");
+    check(losses > 0, "no forced losses among the positions");
+    check(wins + draws + losses >= 50, "too few positions compared with minimax");
+}
+
+static void check_out_of_nodes() {
+    Yngine::EndgameSolver solver{Yngine::EndgameSolverOptions{
+        .table_bytes = 1024 * 1024,
+        .max_markers_left = 51,
+        .solve_last_rows = false,
+        .max_nodes = 100,
+    }};
+
+    for (const auto& board_state : collect_positions(10, 20)) {
+        const auto solved = solver.solve(board_state);
+
+        check(!solved.result, "solver proved a long endgame within 100 nodes");
+        check(!solved.best_move, "unproven solve has a best move");
+        check(solved.nodes <= 101, "solver visited more nodes than it may");
+    }
+
+    // A deadline in the past gives up as well
+    Yngine::EndgameSolver timed_solver{Yngine::EndgameSolverOptions{
+        .table_bytes = 1024 * 1024,
+        .max_markers_left = 51,
+        .solve_last_rows = false,
+        .max_nodes = 1'000'000'000,
+    }};
+
+    const auto solved = timed_solver.solve(collect_positions(1, 20)[0], std::chrono::steady_clock::now());
+    check(!solved.result, "solver proved a long endgame after its deadline");
+    check(solved.nodes <= Yngine::EndgameSolver::DEADLINE_CHECK_NODES, "solver didn't stop at its deadline");
+}
+
+int main() {
+    check_results();
+    check_out_of_nodes();
+
+    return report_failures("endgame solver");
+}
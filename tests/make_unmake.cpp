@@ -0,0 +1,55 @@
+#include <yngine/board_state.hpp>
+#include <XoshiroCpp.hpp>
+
+#include "check.hpp"
+
+#include <iostream>
+#include <random>
+
+// Every move made and taken back has to restore the exact position,
+//   and making it has to give the same position as applying it to a copy
+int main() {
+    XoshiroCpp::Xoshiro256StarStar prng{1337};
+
+    Yngine::MoveList move_list{};
+    Yngine::MoveList compound_move_list{};
+
+    int checked_moves = 0;
+
+    for (int i = 0; i < 300; i++) {
+        Yngine::BoardState board{};
+
+        while (board.get_next_action() != Yngine::NextAction::Done) {
+            board.generate_moves(move_list);
+            board.generate_compound_moves(compound_move_list);
+
+            for (const auto* moves : {&move_list, &compound_move_list}) {
+                for (std::size_t move_index = 0; move_index < moves->get_size(); move_index++) {
+                    const auto move = (*moves)[move_index];
+                    const auto board_before = board;
+
+                    const auto undo = board.make_move(move);
+                    check(board == board_before.with_move(move), "making a move differs from applying it");
+
+                    board.unmake_move(move, undo);
+                    check(
+                        board == board_before && board.hash() == board_before.hash(),
+                        "taking back a move didn't restore the board"
+                    );
+
+                    checked_moves++;
+                }
+            }
+
+            std::uniform_int_distribution<size_t> dist{0, move_list.get_size() - 1};
+            board.apply_move(move_list[dist(prng)]);
+
+            move_list.reset();
+            compound_move_list.reset();
+        }
+    }
+
+    std::cout << "Checked moves: " << checked_moves << std::endl;
+
+    return report_failures("make/unmake");
+}
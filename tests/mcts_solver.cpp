@@ -0,0 +1,132 @@
+#include <yngine/mcts.hpp>
+#include <XoshiroCpp.hpp>
+
+#include "check.hpp"
+
+#include <iostream>
+#include <vector>
+
+static Yngine::GameResult win_of(Yngine::Color color) {
+    return color == Yngine::Color::White ? Yngine::GameResult::WhiteWon : Yngine::GameResult::BlackWon;
+}
+
+// Whether the move wins before the opponent moves again, with the row and ring
+//   removals the player makes after it
+static bool is_winning_move(const Yngine::BoardState& board_state, Yngine::Move move) {
+    const auto color = board_state.whose_move();
+    const auto next_board_state = board_state.with_move(move);
+
+    if (next_board_state.get_next_action() == Yngine::NextAction::Done) {
+        return next_board_state.game_result() == win_of(color);
+    }
+
+    if (next_board_state.whose_move() != color) {
+        return false;
+    }
+
+    Yngine::MoveList move_list;
+    next_board_state.generate_moves(move_list);
+
+    for (std::size_t move_index = 0; move_index < move_list.get_size(); move_index++) {
+        if (is_winning_move(next_board_state, move_list[move_index])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Ring movement positions of random games where the player to move can win
+static std::vector<Yngine::BoardState> collect_winning_positions(std::size_t count) {
+    XoshiroCpp::Xoshiro256StarStar prng{7};
+    std::vector<Yngine::BoardState> positions;
+
+    while (positions.size() < count) {
+        Yngine::BoardState board_state;
+
+        while (board_state.get_next_action() != Yngine::NextAction::Done) {
+            Yngine::MoveList move_list;
+            board_state.generate_moves(move_list);
+
+            if (board_state.get_next_action() == Yngine::NextAction::RingMovement) {
+                for (std::size_t move_index = 0; move_index < move_list.get_size(); move_index++) {
+                    if (is_winning_move(board_state, move_list[move_index])) {
+                        positions.push_back(board_state);
+                        break;
+                    }
+                }
+            }
+
+            board_state.apply_move(move_list.get_random(prng));
+        }
+    }
+
+    return positions;
+}
+
+// The win is found by the terminal positions below the winning move, proving them has to
+//   carry the result through the row and ring removals up to the root and stop the search
+static void check_proves_wins() {
+    constexpr int ITERATION_LIMIT = 1'000'000;
+
+    for (const auto& board_state : collect_winning_positions(20)) {
+        const auto win = win_of(board_state.whose_move());
+
+        for (const int thread_count : {1, 2}) {
+            Yngine::MCTS mcts{64 * 1024 * 1024};
+            mcts.set_board(board_state);
+
+            const auto move = mcts.search(ITERATION_LIMIT, thread_count).get();
+            const auto* root = mcts.get_root();
+
+            check(is_winning_move(board_state, move), "search missed a winning move");
+            check(root->get_proven_result() == win, "root wasn't proven as a win");
+            check(root->get_half_wins_and_simulations().second < ITERATION_LIMIT, "proven root didn't stop the search");
+
+            // The proven root answers without searching again
+            const auto repeated_move = mcts.search(ITERATION_LIMIT, thread_count).get();
+            check(repeated_move == move, "proven root changed its move");
+            check(!mcts.get_search_info().is_searched, "proven root was searched again");
+        }
+    }
+}
+
+// A proven root without children has no move to answer with, so it's searched instead
+static void check_proven_leaf_root() {
+    Yngine::MCTS mcts{16 * 1024 * 1024};
+
+    // After one iteration none of the children of the root has children
+    mcts.search(1, 1).get();
+
+    Yngine::MoveList move_list;
+    mcts.get_board().generate_moves(move_list);
+    mcts.apply_move(move_list[0]);
+
+    auto* root = mcts.get_root();
+    check(root && root->first_child == Yngine::POOL_NULL_INDEX, "root after the move isn't a leaf");
+    if (!root) {
+        return;
+    }
+
+    root->set_proven_result(Yngine::GameResult::Draw);
+
+    const auto move = mcts.search(100, 1).get();
+
+    Yngine::MoveList legal_moves;
+    mcts.get_board().generate_moves(legal_moves);
+
+    bool is_legal = false;
+    for (std::size_t move_index = 0; move_index < legal_moves.get_size(); move_index++) {
+        is_legal |= legal_moves[move_index] == move;
+    }
+
+    check(is_legal, "proven leaf root answered with an illegal move");
+    check(mcts.get_search_info().is_searched, "proven leaf root wasn't searched");
+}
+
+int main() {
+    check_proves_wins();
+    check_proven_leaf_root();
+
+    return report_failures("MCTS solver");
+}
@@ -0,0 +1,106 @@
+#include <yngine/allocators.hpp>
+#include <XoshiroCpp.hpp>
+
+#include "check.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// Same size as the tree nodes, every slot remembers the thread that owns it
+struct alignas(32) Slot {
+    uint32_t owner;
+    uint32_t padding[7];
+
+    Slot(uint32_t owner)
+        : owner{owner}
+        , padding{} {
+    }
+};
+
+using Pool = Yngine::PoolAllocator<Slot>;
+
+// Threads allocate and free at random through their caches and through the shared pool,
+//   a slot handed out twice or a batch lost by the free list shows up as a wrong owner
+static void stress(Pool& pool, uint32_t owner, std::atomic<int>& owner_errors) {
+    constexpr int OPERATIONS = 1'000'000;
+    constexpr std::size_t MAX_HELD = 300;
+
+    Pool::LocalCache cache{pool};
+    XoshiroCpp::Xoshiro256StarStar prng{owner};
+    std::vector<Slot*> held;
+
+    for (int operation = 0; operation < OPERATIONS; operation++) {
+        const bool use_cache = prng() % 4 != 0;
+
+        if (held.size() < MAX_HELD && prng() % 2 == 0) {
+            Slot* slot = use_cache ? cache.allocate(owner) : pool.allocate(owner);
+
+            // The other threads can hold all slots of the pool at once
+            if (slot) {
+                held.push_back(slot);
+            }
+        } else if (!held.empty()) {
+            const std::size_t index = prng() % held.size();
+            Slot* slot = held[index];
+
+            owner_errors += slot->owner != owner;
+
+            held[index] = held.back();
+            held.pop_back();
+
+            if (use_cache) {
+                cache.free(slot);
+            } else {
+                pool.free(slot);
+            }
+        }
+
+        if (!held.empty()) {
+            owner_errors += held[prng() % held.size()]->owner != owner;
+        }
+
+        // Interleaves the threads even on a single core
+        if (prng() % 64 == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    for (Slot* slot : held) {
+        owner_errors += slot->owner != owner;
+        cache.free(slot);
+    }
+}
+
+int main() {
+    constexpr int THREAD_COUNT = 4;
+
+    // Small enough that the threads often run the pool dry
+    Pool pool{1024 * sizeof(Slot)};
+    const std::size_t slot_count = pool.capacity_bytes() / sizeof(Slot) - 1;
+
+    std::atomic<int> owner_errors{0};
+    std::vector<std::thread> threads;
+    for (uint32_t owner = 1; owner <= THREAD_COUNT; owner++) {
+        threads.push_back(std::thread{stress, std::ref(pool), owner, std::ref(owner_errors)});
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    check(owner_errors == 0, "slot was owned by another thread");
+
+    // All slots were freed, so every one of them can be allocated again, each exactly once
+    Pool::LocalCache cache{pool};
+    std::unordered_set<Slot*> slots;
+    while (Slot* slot = cache.allocate(0)) {
+        check(slots.insert(slot).second, "slot was allocated twice");
+    }
+
+    check(slots.size() == slot_count, "freed slots were lost");
+
+    return report_failures("pool allocator");
+}
@@ -0,0 +1,70 @@
+#include <yngine/mcts.hpp>
+
+#include "check.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr int ITERATION_LIMITS[] = {1, 17, 1000, 12345};
+static constexpr int THREAD_COUNTS[] = {1, 3, 8};
+
+// Threads claiming chunks of different sizes together get exactly the iterations of the limit
+static void check_claims() {
+    for (const int limit : ITERATION_LIMITS) {
+        for (const int thread_count : THREAD_COUNTS) {
+            Yngine::SearchBudget search_budget;
+            search_budget.start(limit, 0);
+
+            std::atomic<int> claimed{0};
+            std::vector<std::thread> threads;
+            for (int thread_index = 0; thread_index < thread_count; thread_index++) {
+                threads.push_back(std::thread{[&search_budget, &claimed, thread_index] {
+                    const int max_iterations = 1 + thread_index % Yngine::SearchBudget::CHUNK_ITERATIONS;
+
+                    while (const int iterations = search_budget.claim(max_iterations)) {
+                        claimed += iterations;
+                    }
+                }});
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            const auto name = "limit " + std::to_string(limit) + " with " + std::to_string(thread_count) + " threads";
+            check(claimed == limit, name + " claimed " + std::to_string(claimed) + " iterations");
+            check(search_budget.claim(1) == 0, name + " has iterations left");
+        }
+    }
+}
+
+// Searches run exactly as many iterations as the limit, counting the ones the root already has
+static void check_searches() {
+    for (const int limit : ITERATION_LIMITS) {
+        for (const int thread_count : THREAD_COUNTS) {
+            const auto name = "search of " + std::to_string(limit) + " with " + std::to_string(thread_count) + " threads";
+            const auto expected_simulations = static_cast<uint32_t>(limit);
+
+            Yngine::MCTS mcts{64 * 1024 * 1024};
+            mcts.search(limit, thread_count).get();
+
+            auto simulations = mcts.get_root()->get_half_wins_and_simulations().second;
+            check(simulations == expected_simulations, name + " ran " + std::to_string(simulations) + " iterations");
+
+            mcts.search(2 * limit, thread_count).get();
+
+            simulations = mcts.get_root()->get_half_wins_and_simulations().second;
+            check(simulations == 2 * expected_simulations, name + " continued to " + std::to_string(simulations) + " iterations");
+        }
+    }
+}
+
+int main() {
+    check_claims();
+    check_searches();
+
+    return report_failures("search budget");
+}
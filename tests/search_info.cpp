@@ -0,0 +1,70 @@
+#include <yngine/mcts.hpp>
+#include <yngine/opening_book.hpp>
+#include <XoshiroCpp.hpp>
+
+#include "check.hpp"
+
+#include <filesystem>
+#include <iostream>
+
+// A position of a random game where the player to move has only one legal move
+static Yngine::BoardState find_single_move_position() {
+    XoshiroCpp::Xoshiro256StarStar prng{99};
+
+    while (true) {
+        Yngine::BoardState board_state;
+
+        while (board_state.get_next_action() != Yngine::NextAction::Done) {
+            Yngine::MoveList move_list;
+            board_state.generate_moves(move_list);
+
+            if (move_list.get_size() == 1) {
+                return board_state;
+            }
+
+            board_state.apply_move(move_list.get_random(prng));
+        }
+    }
+}
+
+// Searches report whether the tree chose the move, so callers can tell shortcuts from searches
+int main() {
+    const auto book_path = std::filesystem::temp_directory_path() / "yngine_search_info_test.book";
+
+    Yngine::MCTS mcts{16 * 1024 * 1024};
+
+    mcts.search(2000, 1).get();
+    auto info = mcts.get_search_info();
+    check(info.is_searched, "search of the first move isn't marked as searched");
+    check(info.iterations > 0, "search has no iterations");
+
+    // The book answers the start position, the statistics of the search before are gone
+    const Yngine::BoardState start_board_state;
+    check(Yngine::OpeningBook::write(book_path.string(), {Yngine::OpeningBook::Entry{
+        .key = Yngine::OpeningBook::position_key(start_board_state),
+        .move = Yngine::encode_move(Yngine::PlaceRingMove{60}),
+        .win_rate = 0.5f,
+    }}), "writing the book failed");
+
+    const auto opening_book = Yngine::OpeningBook::open(book_path.string());
+    check(opening_book != nullptr, "opening the book failed");
+
+    mcts.set_board(start_board_state);
+    mcts.set_opening_book(opening_book.get());
+    mcts.search(2000, 1).get();
+    info = mcts.get_search_info();
+    check(!info.is_searched, "move of the book is marked as searched");
+    check(info.root_children.empty(), "move of the book kept the children of the previous search");
+
+    mcts.set_opening_book(nullptr);
+    mcts.search(2000, 1).get();
+    check(mcts.get_search_info().is_searched, "search after the book isn't marked as searched");
+
+    mcts.set_board(find_single_move_position());
+    mcts.search(2000, 1).get();
+    check(!mcts.get_search_info().is_searched, "only legal move is marked as searched");
+
+    std::filesystem::remove(book_path);
+
+    return report_failures("search info");
+}
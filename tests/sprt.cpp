@@ -0,0 +1,24 @@
+#include <sprt.hpp>
+
+#include "check.hpp"
+
+#include <iostream>
+
+// The defaults of the match tool
+int main() {
+    const SPRT sprt{0.0f, 10.0f, 0.05f, 0.05f};
+
+    check(sprt.decide(0, 0, 0) == 0, "no games decided");
+    check(sprt.decide(1, 0, 0) == 0, "a single won game decided");
+    check(sprt.decide(200, 0, 0) == 1, "a clean sweep of A didn't accept H1");
+    check(sprt.decide(0, 0, 200) == -1, "a clean sweep of B didn't accept H0");
+    check(sprt.decide(0, 400, 0) != 1, "only draws accepted H1");
+    check(sprt.decide(150, 0, 50) == 1, "a clear win of A didn't accept H1");
+    check(sprt.decide(50, 0, 150) == -1, "a clear loss of A didn't accept H0");
+    check(sprt.decide(10, 5, 10) == 0, "an even short match decided");
+
+    // The ratio has to grow with the score
+    check(sprt.log_likelihood_ratio(60, 20, 40) > sprt.log_likelihood_ratio(50, 20, 50), "ratio didn't grow with the score");
+
+    return report_failures("SPRT");
+}
@@ -0,0 +1,100 @@
+#include <yngine/board_state.hpp>
+#include <yngine/symmetry.hpp>
+#include <XoshiroCpp.hpp>
+
+#include "check.hpp"
+
+#include <iostream>
+#include <random>
+
+static void check_tables() {
+    for (uint8_t symmetry = 0; symmetry < Yngine::SYMMETRY_COUNT; symmetry++) {
+        bool is_mapped[11*11] = {};
+
+        for (uint8_t index = 0; index < 11*11; index++) {
+            if (!Yngine::Bitboard::is_index_in_game(index)) {
+                continue;
+            }
+
+            const auto transformed_index = Yngine::transform_index(index, symmetry);
+            check(Yngine::Bitboard::is_index_in_game(transformed_index), "symmetry maps a node outside of the board");
+            check(!is_mapped[transformed_index], "symmetry maps two nodes to one");
+            is_mapped[transformed_index] = true;
+
+            const auto inverse = Yngine::inverse_symmetry(symmetry);
+            check(Yngine::transform_index(transformed_index, inverse) == index, "inverse does not undo the symmetry");
+        }
+    }
+}
+
+static void check_random_games() {
+    XoshiroCpp::Xoshiro256StarStar prng{1337};
+    Yngine::MoveList move_list{};
+    Yngine::MoveList transformed_move_list{};
+
+    for (int i = 0; i < 100; i++) {
+        Yngine::BoardState board{};
+
+        while (board.get_next_action() != Yngine::NextAction::Done) {
+            const auto canonical_board = board.canonical().first;
+
+            board.generate_moves(move_list);
+
+            for (uint8_t symmetry = 0; symmetry < Yngine::SYMMETRY_COUNT; symmetry++) {
+                const auto transformed_board = board.transformed(symmetry);
+                check(transformed_board.canonical().first == canonical_board, "symmetric positions have different canonical forms");
+
+                transformed_board.generate_moves(transformed_move_list);
+                check(transformed_move_list.get_size() == move_list.get_size(), "symmetric positions have different numbers of moves");
+
+                // Every move has to be legal in the transformed position and lead to the transformed result
+                for (std::size_t move_index = 0; move_index < move_list.get_size(); move_index++) {
+                    const auto transformed_move = Yngine::transform_move(move_list[move_index], symmetry);
+
+                    bool is_legal = false;
+                    for (std::size_t other_index = 0; other_index < transformed_move_list.get_size(); other_index++) {
+                        if (transformed_move_list[other_index] == transformed_move) {
+                            is_legal = true;
+                            break;
+                        }
+                    }
+                    check(is_legal, "transformed move is not legal in the transformed position");
+
+                    check(
+                        transformed_board.with_move(transformed_move) == board.with_move(move_list[move_index]).transformed(symmetry),
+                        "transformed move leads to a different position"
+                    );
+                }
+
+                transformed_move_list.reset();
+            }
+
+            std::uniform_int_distribution<size_t> dist{0, move_list.get_size() - 1};
+            board.apply_move(move_list[dist(prng)]);
+
+            move_list.reset();
+        }
+    }
+}
+
+static void check_symmetric_moves() {
+    Yngine::BoardState board{};
+    Yngine::MoveList move_list{};
+
+    // The empty board has 85 nodes, the center and 7 orbits of 6 and 3 orbits of 12
+    board.generate_moves(move_list);
+    board.remove_symmetric_moves(move_list);
+    check(move_list.get_size() == 11, "wrong number of distinct first placements");
+}
+
+int main() {
+    check_tables();
+    check_symmetric_moves();
+    check_random_games();
+
+    if (failures == 0) {
+        std::cout << "All symmetry checks passed" << std::endl;
+    }
+
+    return report_failures("symmetry");
+}
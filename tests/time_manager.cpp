@@ -0,0 +1,112 @@
+#include <yngine/time_manager.hpp>
+
+#include "check.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static bool is_close(float lhs, float rhs) {
+    return std::abs(lhs - rhs) < 1e-4f;
+}
+
+static void check_allocation() {
+    struct Case {
+        const char* name;
+        Yngine::TimeControl time_control;
+        float target_seconds;
+        float max_seconds;
+    };
+
+    const Case cases[] = {
+        // 60 / 30 expected moves, three targets are less than a quarter of the clock
+        {"sudden death", {60.0f, 0.0f, 0}, 2.0f, 6.0f},
+        {"increment", {60.0f, 1.0f, 0}, 2.75f, 8.25f},
+        // A quarter of the 10 seconds is less than three targets
+        {"moves to go", {10.0f, 0.0f, 5}, 2.0f, 2.5f},
+        // The target can't be more than the maximum
+        {"last move of the clock", {1.0f, 0.0f, 1}, 0.25f, 0.25f},
+    };
+
+    for (const auto& test_case : cases) {
+        const Yngine::TimeManager time_manager{test_case.time_control};
+
+        check(is_close(time_manager.get_target_seconds(), test_case.target_seconds), std::string{test_case.name} + ": target time");
+        check(is_close(time_manager.get_max_seconds(), test_case.max_seconds), std::string{test_case.name} + ": maximum time");
+        check(is_close(time_manager.get_deadline_seconds(), test_case.target_seconds), std::string{test_case.name} + ": first deadline");
+    }
+}
+
+static void check_updates() {
+    struct Update {
+        float elapsed_seconds;
+        uint32_t search_iterations;
+        uint32_t root_simulations;
+        uint32_t best_simulations;
+        uint32_t second_simulations;
+        // Time the search should stop at after the update
+        float deadline_seconds;
+    };
+
+    struct Case {
+        const char* name;
+        Yngine::TimeControl time_control;
+        std::vector<Update> updates;
+    };
+
+    // Every case but the last has a target of 2 and a maximum of 6 seconds
+    const Yngine::TimeControl time_control{60.0f, 0.0f, 0};
+
+    const Case cases[] = {
+        {"too few iterations", time_control, {
+            {1.0f, 100, 100, 100, 0, 2.0f},
+        }},
+        // 1000 iterations per second leave 1000 until the deadline, less than the lead of the best move
+        {"second can't overtake", time_control, {
+            {1.0f, 1000, 1000, 1600, 100, 1.0f},
+        }},
+        {"settled", time_control, {
+            {0.5f, 10'000, 10'000, 9500, 100, 0.5f},
+        }},
+        {"open and not close", time_control, {
+            {1.8f, 1800, 1800, 500, 300, 2.0f},
+        }},
+        {"close far from the deadline", time_control, {
+            {0.5f, 500, 500, 200, 180, 2.0f},
+        }},
+        // Each extension adds half of the target, only twice
+        {"close before the deadline", time_control, {
+            {1.8f, 1800, 1800, 500, 450, 3.0f},
+            {2.9f, 2900, 2900, 800, 750, 4.0f},
+            {3.9f, 3900, 3900, 1100, 1050, 4.0f},
+        }},
+        // The extension stops at the maximum of 2.5 seconds
+        {"extension capped by the maximum", {10.0f, 0.0f, 5}, {
+            {1.8f, 1800, 1800, 500, 450, 2.5f},
+        }},
+    };
+
+    for (const auto& test_case : cases) {
+        Yngine::TimeManager time_manager{test_case.time_control};
+
+        for (const auto& update : test_case.updates) {
+            const float stop_seconds = time_manager.update(
+                update.elapsed_seconds,
+                update.search_iterations,
+                update.root_simulations,
+                update.best_simulations,
+                update.second_simulations
+            );
+
+            check(is_close(stop_seconds, update.deadline_seconds), std::string{test_case.name} + ": stop time");
+        }
+    }
+}
+
+int main() {
+    check_allocation();
+    check_updates();
+
+    return report_failures("time manager");
+}
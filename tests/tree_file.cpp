@@ -0,0 +1,208 @@
+#include <yngine/mcts.hpp>
+#include <XoshiroCpp.hpp>
+
+#include "check.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+constexpr std::size_t MEMORY_LIMIT_BYTES = 64 * 1024 * 1024;
+constexpr std::size_t NODE_RECORD_SIZE = 24;
+
+static Yngine::BoardState random_board(uint64_t seed, int plies) {
+    XoshiroCpp::Xoshiro256StarStar prng{seed};
+    Yngine::BoardState board_state;
+
+    for (int ply = 0; ply < plies; ply++) {
+        Yngine::MoveList move_list;
+        board_state.generate_moves(move_list);
+        board_state.apply_move(move_list.get_random(prng));
+    }
+
+    return board_state;
+}
+
+// Overwrites bytes of the file at the offset
+static void patch_file(const std::filesystem::path& path, std::size_t offset, const void* data, std::size_t size) {
+    std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+    file.seekp(offset);
+    file.write(static_cast<const char*>(data), size);
+}
+
+static uint8_t read_byte(const std::filesystem::path& path, std::size_t offset) {
+    std::ifstream file{path, std::ios::binary};
+    file.seekg(offset);
+
+    char byte = 0;
+    file.read(&byte, 1);
+
+    return static_cast<uint8_t>(byte);
+}
+
+// Saves the tree, loads it into a new engine and checks that both trees have the same size
+static void check_round_trip(const Yngine::MCTS& saved, const std::filesystem::path& path, const char* message) {
+    check(saved.save_tree(path.string()), message);
+
+    Yngine::MCTS loaded{MEMORY_LIMIT_BYTES};
+    check(loaded.load_tree(path.string()), message);
+    check(loaded.get_node_count() == saved.get_node_count(), message);
+}
+
+int main() {
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto tree_path = directory / "yngine_tree_file_test.bin";
+    const auto corrupt_path = directory / "yngine_tree_file_test_corrupt.bin";
+
+    Yngine::MCTS saved{MEMORY_LIMIT_BYTES};
+    saved.set_board(random_board(7, 14));
+    saved.search(20'000, 2).get();
+
+    const int tree_size = saved.tree_size(saved.get_root());
+    check(saved.save_tree(tree_path.string()), "saving failed");
+
+    // The loaded tree has to be the saved one
+    Yngine::MCTS loaded{MEMORY_LIMIT_BYTES};
+    check(loaded.load_tree(tree_path.string()), "loading failed");
+    check(loaded.get_board() == saved.get_board(), "loaded board differs");
+    check(loaded.tree_size(loaded.get_root()) == tree_size, "loaded tree has a different size");
+    check(loaded.get_node_count() == static_cast<std::size_t>(tree_size), "loaded tree counts a different number of nodes");
+    check(
+        loaded.get_root()->get_half_wins_and_simulations() == saved.get_root()->get_half_wins_and_simulations(),
+        "loaded root has different statistics"
+    );
+
+    // The loaded tree can be searched further and continues from its simulations
+    loaded.search(30'000, 2).get();
+    check(loaded.get_root()->get_half_wins_and_simulations().second == 30'000, "search didn't continue the loaded tree");
+
+    // Trees with compound moves, and pruned trees with proven nodes, are loaded as well
+    Yngine::MCTS compound{MEMORY_LIMIT_BYTES};
+    compound.set_compound_moves(true);
+    compound.set_board(random_board(17, 40));
+    compound.search(20'000, 2).get();
+    check_round_trip(compound, tree_path, "a tree with compound moves wasn't loaded");
+
+    Yngine::MCTS pruned{2 * 1024 * 1024};
+    pruned.set_board(random_board(19, 60));
+    pruned.search(200'000, 2).get();
+    check(pruned.get_reclaimed_nodes() > 0, "the tree wasn't pruned");
+    check_round_trip(pruned, tree_path, "a pruned tree wasn't loaded");
+
+    // A tree of another position is dropped by the next search, so it isn't saved either
+    Yngine::MCTS moved{MEMORY_LIMIT_BYTES};
+    moved.set_board(random_board(23, 14));
+    moved.search(2'000, 1).get();
+    moved.set_board(random_board(29, 14));
+    check(moved.save_tree(tree_path.string()), "saving a tree of another position failed");
+    check(loaded.load_tree(tree_path.string()), "loading a tree of another position failed");
+    check(!loaded.get_root(), "a tree of another position was saved");
+    check(saved.save_tree(tree_path.string()), "saving failed");
+
+    // A rejected file has to leave the engine as it was
+    Yngine::MCTS other{MEMORY_LIMIT_BYTES};
+    const auto other_board = random_board(11, 16);
+    other.set_board(other_board);
+    other.search(5'000, 1).get();
+    const int other_tree_size = other.tree_size(other.get_root());
+
+    const auto check_unchanged = [&](const char* message) {
+        check(other.get_board() == other_board, message);
+        check(other.tree_size(other.get_root()) == other_tree_size, message);
+    };
+
+    const std::size_t file_size = std::filesystem::file_size(tree_path);
+    const std::size_t header_size = file_size - tree_size * NODE_RECORD_SIZE;
+    // The move of the first child, after the statistics of its record
+    const std::size_t move_offset = header_size + NODE_RECORD_SIZE + 8;
+
+    const uint8_t unknown_move_type = 0x7f;
+    std::filesystem::copy_file(tree_path, corrupt_path, std::filesystem::copy_options::overwrite_existing);
+    patch_file(corrupt_path, move_offset, &unknown_move_type, sizeof(unknown_move_type));
+    check(!other.load_tree(corrupt_path.string()), "a node with an unknown move type was loaded");
+    check_unchanged("a node with an unknown move type changed the engine");
+
+    const uint8_t outside_index = 0;
+    std::filesystem::copy_file(tree_path, corrupt_path, std::filesystem::copy_options::overwrite_existing);
+    patch_file(corrupt_path, move_offset + 1, &outside_index, sizeof(outside_index));
+    check(!other.load_tree(corrupt_path.string()), "a move outside of the board was loaded");
+    check_unchanged("a move outside of the board changed the engine");
+
+    // The root claims one more child than the file has
+    const std::size_t root_child_count_offset = header_size + 12;
+    uint16_t root_child_count;
+    {
+        std::ifstream file{tree_path, std::ios::binary};
+        file.seekg(root_child_count_offset);
+        file.read(reinterpret_cast<char*>(&root_child_count), sizeof(root_child_count));
+    }
+    root_child_count++;
+    std::filesystem::copy_file(tree_path, corrupt_path, std::filesystem::copy_options::overwrite_existing);
+    patch_file(corrupt_path, root_child_count_offset, &root_child_count, sizeof(root_child_count));
+    check(!other.load_tree(corrupt_path.string()), "a tree with a missing node was loaded");
+    check_unchanged("a tree with a missing node changed the engine");
+
+    // The root claims to be fully expanded while selection didn't add all of its children
+    const std::size_t root_flags_offset = header_size + 16;
+    const uint8_t wrong_root_flags = read_byte(tree_path, root_flags_offset) ^ Yngine::MCTSNode::IS_FULLY_EXPANDED;
+    std::filesystem::copy_file(tree_path, corrupt_path, std::filesystem::copy_options::overwrite_existing);
+    patch_file(corrupt_path, root_flags_offset, &wrong_root_flags, sizeof(wrong_root_flags));
+    check(!other.load_tree(corrupt_path.string()), "a node with wrong expansion flags was loaded");
+    check_unchanged("a node with wrong expansion flags changed the engine");
+
+    // A single proven root without children has no move to answer with
+    const uint64_t single_node_count = 1;
+    const uint16_t no_children[2] = {0, 0};
+    const uint8_t proven_flags = static_cast<uint8_t>((static_cast<uint8_t>(Yngine::GameResult::WhiteWon) + 1) << 3);
+    std::filesystem::copy_file(tree_path, corrupt_path, std::filesystem::copy_options::overwrite_existing);
+    patch_file(corrupt_path, 16, &single_node_count, sizeof(single_node_count));
+    patch_file(corrupt_path, root_child_count_offset, no_children, sizeof(no_children));
+    patch_file(corrupt_path, root_flags_offset, &proven_flags, sizeof(proven_flags));
+    std::filesystem::resize_file(corrupt_path, header_size + NODE_RECORD_SIZE);
+    check(!other.load_tree(corrupt_path.string()), "a proven leaf that isn't the end of the game was loaded");
+    check_unchanged("a proven leaf that isn't the end of the game changed the engine");
+
+    // The header ends with the board of the game and the board of the root
+    const std::size_t board_offset = header_size - 2 * sizeof(Yngine::BoardState);
+    const std::size_t root_board_offset = header_size - sizeof(Yngine::BoardState);
+
+    const uint8_t unknown_next_action = 0x7f;
+    std::filesystem::copy_file(tree_path, corrupt_path, std::filesystem::copy_options::overwrite_existing);
+    patch_file(corrupt_path, board_offset, &unknown_next_action, sizeof(unknown_next_action));
+    check(!other.load_tree(corrupt_path.string()), "a board with an unknown next action was loaded");
+    check_unchanged("a board with an unknown next action changed the engine");
+
+    // The last bitboard of the board gets a marker on a bit outside of the board
+    const std::size_t last_bitboard_byte_offset = root_board_offset + sizeof(Yngine::BoardState) - 1;
+    const uint8_t marker_outside = read_byte(tree_path, last_bitboard_byte_offset) | 0x80;
+    std::filesystem::copy_file(tree_path, corrupt_path, std::filesystem::copy_options::overwrite_existing);
+    patch_file(corrupt_path, last_bitboard_byte_offset, &marker_outside, sizeof(marker_outside));
+    check(!other.load_tree(corrupt_path.string()), "a board with a marker outside of the board was loaded");
+    check_unchanged("a board with a marker outside of the board changed the engine");
+
+    const auto unrelated_board = random_board(31, 14);
+    std::filesystem::copy_file(tree_path, corrupt_path, std::filesystem::copy_options::overwrite_existing);
+    patch_file(corrupt_path, root_board_offset, &unrelated_board, sizeof(unrelated_board));
+    check(!other.load_tree(corrupt_path.string()), "a tree of another position than the board was loaded");
+    check_unchanged("a tree of another position than the board changed the engine");
+
+    std::filesystem::copy_file(tree_path, corrupt_path, std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::resize_file(corrupt_path, file_size - NODE_RECORD_SIZE / 2);
+    check(!other.load_tree(corrupt_path.string()), "a truncated file was loaded");
+    check_unchanged("a truncated file changed the engine");
+
+    check(!other.load_tree((directory / "yngine_tree_file_test_missing.bin").string()), "a missing file was loaded");
+    check_unchanged("a missing file changed the engine");
+
+    // More nodes than the memory of the engine holds
+    Yngine::MCTS small{1024 * 1024};
+    const auto small_board = random_board(13, 12);
+    small.set_board(small_board);
+    check(!small.load_tree(tree_path.string()), "a tree larger than the memory was loaded");
+    check(small.get_board() == small_board, "a tree larger than the memory changed the engine");
+
+    std::filesystem::remove(tree_path);
+    std::filesystem::remove(corrupt_path);
+
+    return report_failures("tree file");
+}
@@ -0,0 +1,75 @@
+#include <yngine/mcts.hpp>
+#include <yngine/opening_book.hpp>
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// Searches every ring placement position up to the given number of plies, symmetric
+//   positions only once, and writes the best moves as an opening book. The number of
+//   positions grows about 80 times with each ply, so more than 3 plies takes very long.
+//   usage: build_opening_book <output file> [plies] [iterations per position] [memory limit in MB]
+int main(int argc, const char** argv) {
+    if (argc < 2) {
+        std::cerr << "Expected the path of the book to write as the first argument" << std::endl;
+        return 1;
+    }
+
+    const std::string file_path = argv[1];
+    const int max_plies = argc > 2 ? std::stoi(argv[2]) : 2;
+    const int iterations = argc > 3 ? std::stoi(argv[3]) : 1'000'000;
+    const std::size_t memory_limit_mb = argc > 4 ? std::stoull(argv[4]) : 1024;
+    const int thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    Yngine::MCTS mcts{memory_limit_mb * 1024 * 1024};
+
+    std::vector<Yngine::OpeningBook::Entry> entries;
+    std::vector<Yngine::BoardState> positions{Yngine::BoardState{}};
+
+    for (int ply = 0; ply < max_plies && !positions.empty(); ply++) {
+        std::vector<Yngine::BoardState> next_positions;
+        std::unordered_set<uint64_t> next_keys;
+
+        for (std::size_t position_index = 0; position_index < positions.size(); position_index++) {
+            const auto& position = positions[position_index];
+
+            mcts.set_board(position);
+            const auto move = mcts.search(iterations, thread_count).get();
+
+            entries.push_back(Yngine::OpeningBook::Entry{
+                .key = Yngine::OpeningBook::position_key(position),
+                .move = Yngine::encode_move(move),
+                .win_rate = mcts.get_search_info().win_rate,
+            });
+
+            std::cout
+                << "ply " << ply
+                << ": position " << (position_index + 1) << "/" << positions.size()
+                << ", win rate " << entries.back().win_rate
+                << std::endl;
+
+            // Positions are kept in their canonical orientation, so the moves are too
+            Yngine::MoveList move_list;
+            position.generate_moves(move_list);
+            for (std::size_t move_index = 0; move_index < move_list.get_size(); move_index++) {
+                const auto next_position = position.with_move(move_list[move_index]).canonical().first;
+
+                if (next_position.get_next_action() == Yngine::NextAction::RingPlacement
+                    && next_keys.insert(next_position.hash()).second) {
+                    next_positions.push_back(next_position);
+                }
+            }
+        }
+
+        positions = std::move(next_positions);
+    }
+
+    if (!Yngine::OpeningBook::write(file_path, std::move(entries))) {
+        std::cerr << "Failed to write the book to " << file_path << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
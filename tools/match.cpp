@@ -0,0 +1,251 @@
+#include <yngine/mcts.hpp>
+#include <yngine/alpha_beta.hpp>
+
+#include "sprt.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Settings of one side of the match, parsed from "key=value,key=value"
+struct EngineConfig {
+    // Either "mcts" or "alphabeta"
+    std::string engine = "mcts";
+    // Iterations per move for the search, nodes for alpha-beta. Used if seconds are zero
+    int iterations = 10'000;
+    float seconds = 0.0f;
+    int threads = 1;
+    std::size_t memory_mb = 256;
+    bool compound_moves = false;
+    std::size_t board_cache_mb = 0;
+    std::size_t solver_mb = 0;
+};
+
+static EngineConfig parse_config(const std::string& text) {
+    EngineConfig config;
+
+    std::stringstream stream{text};
+    std::string option;
+    while (std::getline(stream, option, ',')) {
+        const auto separator = option.find('=');
+        if (separator == std::string::npos) {
+            std::cerr << "Expected key=value, got " << option << std::endl;
+            std::exit(1);
+        }
+
+        const auto key = option.substr(0, separator);
+        const auto value = option.substr(separator + 1);
+
+        if (key == "engine") {
+            config.engine = value;
+        } else if (key == "iterations") {
+            config.iterations = std::stoi(value);
+        } else if (key == "seconds") {
+            config.seconds = std::stof(value);
+        } else if (key == "threads") {
+            config.threads = std::stoi(value);
+        } else if (key == "memory_mb") {
+            config.memory_mb = std::stoull(value);
+        } else if (key == "compound") {
+            config.compound_moves = std::stoi(value) != 0;
+        } else if (key == "board_cache_mb") {
+            config.board_cache_mb = std::stoull(value);
+        } else if (key == "solver_mb") {
+            config.solver_mb = std::stoull(value);
+        } else {
+            std::cerr << "Unknown engine option " << key << std::endl;
+            std::exit(1);
+        }
+    }
+
+    if (config.engine != "mcts" && config.engine != "alphabeta") {
+        std::cerr << "Unknown engine " << config.engine << std::endl;
+        std::exit(1);
+    }
+
+    return config;
+}
+
+// One engine playing one game
+class Player {
+public:
+    Player(const EngineConfig& config)
+        : config{config} {
+        if (config.engine == "mcts") {
+            this->mcts = std::make_unique<Yngine::MCTS>(config.memory_mb * 1024 * 1024);
+            this->mcts->set_compound_moves(config.compound_moves);
+            this->mcts->set_board_cache(Yngine::BoardCacheOptions{.capacity_bytes = config.board_cache_mb * 1024 * 1024});
+            this->mcts->set_endgame_solver(Yngine::EndgameSolverOptions{.table_bytes = config.solver_mb * 1024 * 1024});
+        } else {
+            this->alpha_beta = std::make_unique<Yngine::AlphaBeta>(config.memory_mb * 1024 * 1024);
+        }
+    }
+
+    Yngine::Move search() {
+        Yngine::SearchLimit limit = this->config.iterations;
+        if (this->config.seconds > 0.0f) {
+            limit = this->config.seconds;
+        }
+
+        if (this->mcts) {
+            return this->mcts->search(limit, this->config.threads).get();
+        } else {
+            return this->alpha_beta->search(limit, this->config.threads).get();
+        }
+    }
+
+    void apply_move(Yngine::Move move) {
+        if (this->mcts) {
+            this->mcts->apply_move(move);
+        } else {
+            this->alpha_beta->apply_move(move);
+        }
+    }
+
+private:
+    const EngineConfig config;
+    std::unique_ptr<Yngine::MCTS> mcts;
+    std::unique_ptr<Yngine::AlphaBeta> alpha_beta;
+};
+
+// Plays one game from the opening, returns the result for engine A
+static int play_game(const EngineConfig& config_a, const EngineConfig& config_b, const std::vector<Yngine::Move>& opening, Yngine::Color color_a) {
+    Player player_a{config_a};
+    Player player_b{config_b};
+
+    Yngine::BoardState board_state;
+    for (const auto move : opening) {
+        board_state.apply_move(move);
+        player_a.apply_move(move);
+        player_b.apply_move(move);
+    }
+
+    while (board_state.get_next_action() != Yngine::NextAction::Done) {
+        Player& player = board_state.whose_move() == color_a ? player_a : player_b;
+        const auto move = player.search();
+
+        board_state.apply_move(move);
+        player_a.apply_move(move);
+        player_b.apply_move(move);
+    }
+
+    const auto result = board_state.game_result();
+    if (result == Yngine::GameResult::Draw) {
+        return 0;
+    }
+
+    const auto winner = result == Yngine::GameResult::WhiteWon ? Yngine::Color::White : Yngine::Color::Black;
+    return winner == color_a ? 1 : -1;
+}
+
+// Plays engine A against engine B, both colors of every random opening, several games
+//   at once, until the SPRT decides or the maximum number of games is reached.
+//   usage: match <engine A options> <engine B options> [max games] [concurrent pairs]
+//              [opening plies] [elo0] [elo1] [alpha] [beta]
+//   where options are e.g. "engine=mcts,iterations=20000,threads=1"
+int main(int argc, const char** argv) {
+    if (argc < 3) {
+        std::cerr << "Expected the options of both engines as the first two arguments" << std::endl;
+        return 1;
+    }
+
+    const auto config_a = parse_config(argv[1]);
+    const auto config_b = parse_config(argv[2]);
+    const int max_games = argc > 3 ? std::stoi(argv[3]) : 1000;
+    const int concurrent_pairs = argc > 4 ? std::stoi(argv[4]) : std::max(1u, std::thread::hardware_concurrency() / 2);
+    const int opening_plies = argc > 5 ? std::stoi(argv[5]) : 4;
+    const float elo0 = argc > 6 ? std::stof(argv[6]) : 0.0f;
+    const float elo1 = argc > 7 ? std::stof(argv[7]) : 10.0f;
+    const float alpha = argc > 8 ? std::stof(argv[8]) : 0.05f;
+    const float beta = argc > 9 ? std::stof(argv[9]) : 0.05f;
+
+    const SPRT sprt{elo0, elo1, alpha, beta};
+
+    std::mutex mutex;
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+    int started_pairs = 0;
+    int decision = 0;
+
+    const auto worker = [&](uint64_t seed) {
+        std::mt19937_64 prng{seed};
+
+        while (true) {
+            {
+                std::unique_lock lock{mutex};
+                if (decision != 0 || started_pairs * 2 >= max_games) {
+                    return;
+                }
+                started_pairs++;
+            }
+
+            // Both games of a pair start from the same random ring placements
+            std::vector<Yngine::Move> opening;
+            Yngine::BoardState board_state;
+            for (int ply = 0; ply < opening_plies; ply++) {
+                Yngine::MoveList move_list;
+                board_state.generate_moves(move_list);
+
+                std::uniform_int_distribution<std::size_t> distribution{0, move_list.get_size() - 1};
+                const auto move = move_list[distribution(prng)];
+
+                opening.push_back(move);
+                board_state.apply_move(move);
+            }
+
+            for (const auto color_a : {Yngine::Color::White, Yngine::Color::Black}) {
+                const int result = play_game(config_a, config_b, opening, color_a);
+
+                std::unique_lock lock{mutex};
+                wins += result > 0;
+                draws += result == 0;
+                losses += result < 0;
+
+                if (decision == 0) {
+                    decision = sprt.decide(wins, draws, losses);
+                }
+
+                const int games = wins + draws + losses;
+                const double score = (wins + 0.5 * draws) / games;
+
+                std::cout
+                    << "games " << games
+                    << ", A wins " << wins << " draws " << draws << " losses " << losses
+                    << ", score " << score
+                    << ", LLR " << sprt.log_likelihood_ratio(wins, draws, losses)
+                    << " [" << sprt.get_lower_bound() << ", " << sprt.get_upper_bound() << "]"
+                    << std::endl;
+            }
+        }
+    };
+
+    std::random_device rd;
+    std::vector<std::thread> workers;
+    for (int pair_index = 0; pair_index < concurrent_pairs; pair_index++) {
+        workers.push_back(std::thread{worker, (static_cast<uint64_t>(rd()) << 32) | rd()});
+    }
+
+    for (auto& worker_thread : workers) {
+        worker_thread.join();
+    }
+
+    const int games = wins + draws + losses;
+    const double score = games > 0 ? (wins + 0.5 * draws) / games : 0.5;
+    const double clamped_score = std::clamp(score, 0.001, 0.999);
+
+    std::cout
+        << "Result: " << (decision > 0 ? "H1 accepted" : decision < 0 ? "H0 accepted" : "undecided")
+        << ", games " << games
+        << ", elo " << (-400.0 * std::log10(1.0 / clamped_score - 1.0))
+        << std::endl;
+
+    return 0;
+}
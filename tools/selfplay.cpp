@@ -0,0 +1,231 @@
+#include <yngine/search_service.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One position of a self-play game, every record has the same size so files can be
+//   read by seeking to a multiple of it. Bitboards are stored as low and high halves
+struct SelfplayRecord {
+    static constexpr std::size_t MAX_MOVES = 16;
+
+    uint64_t white_rings[2];
+    uint64_t black_rings[2];
+    uint64_t white_markers[2];
+    uint64_t black_markers[2];
+
+    uint8_t next_action;
+    // Color of the player to move
+    uint8_t side;
+    // Zero for a draw, one if white won and two if black won
+    uint8_t result;
+    uint8_t move_count;
+    uint32_t root_simulations;
+
+    // Moves of the root with the most simulations, encoded with encode_move
+    struct {
+        uint32_t move;
+        uint32_t simulations;
+    } moves[MAX_MOVES];
+};
+
+static_assert(sizeof(SelfplayRecord) == 200);
+
+struct Game {
+    Yngine::SearchService::SessionId session_id;
+    Yngine::BoardState board_state;
+    std::future<Yngine::Move> move;
+    int plies;
+    // Records of the game so far, written once the result is known
+    std::vector<SelfplayRecord> records;
+};
+
+static void split_bitboard(Yngine::Bitboard bitboard, uint64_t halves[2]) {
+    halves[0] = bitboard.get_bits();
+    halves[1] = bitboard.get_bits() >> 64;
+}
+
+static SelfplayRecord make_record(const Yngine::BoardState& board_state, const Yngine::SearchInfo& info) {
+    SelfplayRecord record{};
+
+    split_bitboard(board_state.get_rings(Yngine::Color::White), record.white_rings);
+    split_bitboard(board_state.get_rings(Yngine::Color::Black), record.black_rings);
+    split_bitboard(board_state.get_markers(Yngine::Color::White), record.white_markers);
+    split_bitboard(board_state.get_markers(Yngine::Color::Black), record.black_markers);
+
+    record.next_action = static_cast<uint8_t>(board_state.get_next_action());
+    record.side = static_cast<uint8_t>(board_state.whose_move());
+    record.root_simulations = info.root_simulations;
+
+    auto children = info.root_children;
+    std::sort(children.begin(), children.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.simulations > rhs.simulations;
+    });
+
+    record.move_count = std::min(children.size(), SelfplayRecord::MAX_MOVES);
+    for (std::size_t move_index = 0; move_index < record.move_count; move_index++) {
+        record.moves[move_index].move = Yngine::encode_move(children[move_index].move);
+        record.moves[move_index].simulations = children[move_index].simulations;
+    }
+
+    return record;
+}
+
+// Picks a move with probability proportional to its simulations, so games don't repeat
+static Yngine::Move sample_move(const Yngine::SearchInfo& info, std::mt19937_64& prng) {
+    std::vector<double> weights;
+    for (const auto& child : info.root_children) {
+        weights.push_back(child.simulations);
+    }
+
+    std::discrete_distribution<std::size_t> distribution{weights.begin(), weights.end()};
+
+    return info.root_children[distribution(prng)].move;
+}
+
+// Plays games of the search against itself, many at once on shared worker threads, and
+//   appends a record of every searched position to the output file.
+//   usage: selfplay <output file> [games] [concurrent games] [iterations per move] [sampled plies] [memory limit in MB]
+int main(int argc, const char** argv) {
+    if (argc < 2) {
+        std::cerr << "Expected the path of the file to append the records to as the first argument" << std::endl;
+        return 1;
+    }
+
+    const std::string file_path = argv[1];
+    const int game_count = argc > 2 ? std::stoi(argv[2]) : 100;
+    const int concurrent_games = argc > 3 ? std::stoi(argv[3]) : 16;
+    const int iterations = argc > 4 ? std::stoi(argv[4]) : 10'000;
+    const int sampled_plies = argc > 5 ? std::stoi(argv[5]) : 10;
+    const std::size_t memory_limit_mb = argc > 6 ? std::stoull(argv[6]) : 4096;
+    const int thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    // Records are collected and written in big blocks, not one by one
+    constexpr std::size_t WRITE_BUFFER_RECORDS = 4096;
+    std::vector<SelfplayRecord> write_buffer;
+    write_buffer.reserve(WRITE_BUFFER_RECORDS);
+
+    std::ofstream output{file_path, std::ios::binary | std::ios::app};
+    if (!output) {
+        std::cerr << "Failed to open " << file_path << std::endl;
+        return 1;
+    }
+
+    const auto flush = [&] {
+        output.write(reinterpret_cast<const char*>(write_buffer.data()), write_buffer.size() * sizeof(SelfplayRecord));
+        write_buffer.clear();
+    };
+
+    const std::size_t memory_limit_bytes = memory_limit_mb * 1024 * 1024;
+    Yngine::SearchService service{memory_limit_bytes, thread_count};
+
+    std::random_device rd;
+    std::mt19937_64 prng{(static_cast<uint64_t>(rd()) << 32) | rd()};
+
+    std::vector<Game> games;
+    int started_games = 0;
+    int finished_games = 0;
+    std::size_t written_records = 0;
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    const auto start_search = [&](Game& game) {
+        game.move = service.search(game.session_id, iterations);
+    };
+
+    for (; started_games < std::min(game_count, concurrent_games); started_games++) {
+        Game game{
+            .session_id = service.create_session(memory_limit_bytes / concurrent_games),
+            .board_state = Yngine::BoardState{},
+            .move = {},
+            .plies = 0,
+            .records = {},
+        };
+        games.push_back(std::move(game));
+        start_search(games.back());
+    }
+
+    while (!games.empty()) {
+        for (std::size_t game_index = 0; game_index < games.size();) {
+            Game& game = games[game_index];
+
+            if (game.move.wait_for(std::chrono::milliseconds{1}) != std::future_status::ready) {
+                game_index++;
+                continue;
+            }
+
+            auto move = game.move.get();
+
+            // Moves answered without a search have no statistics to learn from
+            const auto info = service.get_search_info(game.session_id);
+
+            if (info.is_searched) {
+                game.records.push_back(make_record(game.board_state, info));
+
+                if (game.plies < sampled_plies && !info.root_children.empty()) {
+                    move = sample_move(info, prng);
+                }
+            }
+
+            game.board_state.apply_move(move);
+            service.apply_move(game.session_id, move);
+            game.plies++;
+
+            if (game.board_state.get_next_action() != Yngine::NextAction::Done) {
+                start_search(game);
+                game_index++;
+                continue;
+            }
+
+            const auto result = static_cast<uint8_t>(game.board_state.game_result());
+            for (auto& record : game.records) {
+                record.result = result;
+
+                write_buffer.push_back(record);
+                if (write_buffer.size() == WRITE_BUFFER_RECORDS) {
+                    flush();
+                }
+            }
+            written_records += game.records.size();
+            finished_games++;
+
+            const auto elapsed_hours = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count() / 3600.0;
+            std::cout
+                << "games " << finished_games << "/" << game_count
+                << ", positions " << written_records
+                << ", games/hour " << (finished_games / elapsed_hours)
+                << std::endl;
+
+            // The session starts over with the next game
+            if (started_games < game_count) {
+                started_games++;
+
+                game.board_state = Yngine::BoardState{};
+                game.plies = 0;
+                game.records.clear();
+                service.set_board(game.session_id, game.board_state);
+
+                start_search(game);
+                game_index++;
+            } else {
+                service.close_session(game.session_id);
+                games.erase(games.begin() + game_index);
+            }
+        }
+    }
+
+    flush();
+
+    const auto elapsed_hours = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count() / 3600.0;
+    std::cout
+        << "Games/hour: " << (finished_games / elapsed_hours)
+        << ", positions/hour: " << (written_records / elapsed_hours)
+        << std::endl;
+
+    return output.good() ? 0 : 1;
+}
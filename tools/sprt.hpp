@@ -0,0 +1,72 @@
+#ifndef YNGINE_TOOLS_SPRT_HPP
+#define YNGINE_TOOLS_SPRT_HPP
+
+#include <cmath>
+
+// Sequential probability ratio test of the score of engine A, with the trinomial
+//   results approximated by a normal distribution of the score per game
+class SPRT {
+public:
+    SPRT(float elo0, float elo1, float alpha, float beta)
+        : score0{SPRT::elo_to_score(elo0)}
+        , score1{SPRT::elo_to_score(elo1)}
+        , lower_bound{std::log(beta / (1.0f - alpha))}
+        , upper_bound{std::log((1.0f - beta) / alpha)} {
+    }
+
+    // Zero while undecided, otherwise one if A is better by elo1 and minus one if it isn't better by elo0
+    int decide(int wins, int draws, int losses) const {
+        const double llr = this->log_likelihood_ratio(wins, draws, losses);
+
+        if (llr >= this->upper_bound) {
+            return 1;
+        } else if (llr <= this->lower_bound) {
+            return -1;
+        }
+
+        return 0;
+    }
+
+    double log_likelihood_ratio(int wins, int draws, int losses) const {
+        const double games = wins + draws + losses;
+        if (games == 0) {
+            return 0.0;
+        }
+
+        const double score = (wins + 0.5 * draws) / games;
+        double variance = (
+            wins * (1.0 - score) * (1.0 - score) +
+            draws * (0.5 - score) * (0.5 - score) +
+            losses * score * score
+        ) / games;
+
+        // Results without spread, as a clean sweep, take the variance of decisive games
+        //   between the hypotheses instead
+        if (variance <= 0.0) {
+            const double middle_score = 0.5 * (this->score0 + this->score1);
+            variance = middle_score * (1.0 - middle_score);
+        }
+
+        return games * (this->score1 - this->score0) * (2.0 * score - this->score0 - this->score1) / (2.0 * variance);
+    }
+
+    float get_lower_bound() const {
+        return this->lower_bound;
+    }
+
+    float get_upper_bound() const {
+        return this->upper_bound;
+    }
+
+private:
+    static double elo_to_score(float elo) {
+        return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+    }
+
+    const double score0;
+    const double score1;
+    const float lower_bound;
+    const float upper_bound;
+};
+
+#endif // YNGINE_TOOLS_SPRT_HPP
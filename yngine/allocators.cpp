@@ -1,9 +1,12 @@
 #include <yngine/allocators.hpp>
 
 #include <iostream>
+#include <algorithm>
 
 #if defined(__linux__) || defined(EMSCRIPTEN)
 #include <sys/mman.h>
+#include <fstream>
+#include <string>
 #elif defined(_WIN32)
 #include <Windows.h>
 #else
@@ -12,11 +15,90 @@ static_assert(false);
 
 namespace Yngine {
 
-ArenaAllocator::ArenaAllocator(std::size_t capacity)
+constexpr std::size_t ARENA_PAGE_SIZE = 4 * 1024;
+constexpr std::size_t ARENA_HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+static std::size_t round_up(std::size_t size, std::size_t alignment) {
+    return (size + (alignment - 1)) & -alignment;
+}
+
+#if defined(__linux__)
+// madvise accepts the hint whenever the kernel has transparent huge pages built in,
+//   also if they are turned off, so we read the mode the kernel is set to
+static bool are_transparent_huge_pages_enabled() {
+    std::ifstream file{"/sys/kernel/mm/transparent_hugepage/enabled"};
+
+    std::string modes;
+    if (!std::getline(file, modes)) {
+        return false;
+    }
+
+    return modes.find("[never]") == std::string::npos;
+}
+#endif
+
+ArenaAllocator::ArenaAllocator(std::size_t capacity, ArenaOptions options)
     : capacity{capacity}
-    , used{0} {
-#if defined(__linux__) || defined(EMSCRIPTEN)
-    const auto data = mmap(
+    , used{0}
+    , options{options}
+    , huge_pages_mapped{false} {
+#if defined(__linux__)
+    void* data = MAP_FAILED;
+
+    if (options.huge_pages == HugePages::Explicit) {
+        // Without MAP_NORESERVE the mapping fails right away if there aren't enough
+        // huge pages reserved, instead of crashing on the first touch of a missing page
+        this->mapping_size = round_up(capacity, ARENA_HUGE_PAGE_SIZE);
+        data = mmap(
+            nullptr,
+            this->mapping_size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+            -1,
+            0
+        );
+
+        if (data != MAP_FAILED) {
+            this->mapping = data;
+            this->huge_pages_mapped = true;
+        }
+    }
+
+    if (data == MAP_FAILED) {
+        // Map one huge page more than needed so the data can be aligned to a huge page,
+        // otherwise the first and last pages of the arena can't be huge pages
+        this->mapping_size =
+            options.huge_pages == HugePages::None ? capacity : capacity + ARENA_HUGE_PAGE_SIZE;
+
+        this->mapping = mmap(
+            nullptr,
+            this->mapping_size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+            -1,
+            0
+        );
+
+        if (this->mapping == MAP_FAILED) {
+            std::cerr << "Failed to allocate an arena using mmap" << std::endl;
+            std::abort();
+        }
+
+        data = this->mapping;
+
+        if (options.huge_pages != HugePages::None) {
+            data = reinterpret_cast<void*>(
+                round_up(reinterpret_cast<std::uintptr_t>(this->mapping), ARENA_HUGE_PAGE_SIZE)
+            );
+
+            // It's only a hint, if transparent huge pages are disabled we still get regular pages
+            this->huge_pages_mapped =
+                madvise(data, capacity, MADV_HUGEPAGE) == 0 && are_transparent_huge_pages_enabled();
+        }
+    }
+#elif defined(EMSCRIPTEN)
+    this->mapping_size = capacity;
+    this->mapping = mmap(
         nullptr,
         capacity,
         PROT_READ | PROT_WRITE,
@@ -25,32 +107,62 @@ ArenaAllocator::ArenaAllocator(std::size_t capacity)
         0
     );
 
-    if (data == MAP_FAILED) {
+    if (this->mapping == MAP_FAILED) {
         std::cerr << "Failed to allocate an arena using mmap" << std::endl;
         std::abort();
     }
+
+    const auto data = this->mapping;
 #elif defined(_WIN32)
-    const auto data = VirtualAlloc(
-        nullptr,
-        capacity,
-        MEM_COMMIT | MEM_RESERVE,
-        PAGE_READWRITE
-    );
+    void* data = nullptr;
+
+    // Large pages need the "Lock pages in memory" privilege, without it the allocation fails
+    if (options.huge_pages != HugePages::None) {
+        const auto large_page_size = GetLargePageMinimum();
+
+        if (large_page_size != 0) {
+            this->mapping_size = round_up(capacity, large_page_size);
+            data = VirtualAlloc(
+                nullptr,
+                this->mapping_size,
+                MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES,
+                PAGE_READWRITE
+            );
+
+            this->huge_pages_mapped = data != nullptr;
+        }
+    }
+
+    if (data == nullptr) {
+        this->mapping_size = capacity;
+        data = VirtualAlloc(
+            nullptr,
+            capacity,
+            MEM_COMMIT | MEM_RESERVE,
+            PAGE_READWRITE
+        );
+    }
 
     if (data == nullptr) {
         std::cerr << "Failed to allocate an arena using VirtualAlloc" << std::endl;
         std::abort();
     }
+
+    this->mapping = data;
 #endif
 
     this->data = static_cast<uint8_t*>(data);
+
+    if (options.prefault) {
+        this->prefault_pages();
+    }
 }
 
 ArenaAllocator::~ArenaAllocator() {
 #if defined(__linux__)
-    munmap(this->data, this->capacity);
+    munmap(this->mapping, this->mapping_size);
 #elif defined(_WIN32)
-    VirtualFree(this->data, 0, MEM_RELEASE);
+    VirtualFree(this->mapping, 0, MEM_RELEASE);
 #endif
 }
 
@@ -72,6 +184,23 @@ uint8_t* ArenaAllocator::allocate_aligned(std::size_t bytes, std::size_t alignme
 }
 
 void ArenaAllocator::clear() {
+    if (this->options.release_on_clear) {
+        const auto used_pages = std::min(round_up(this->used, ARENA_PAGE_SIZE), this->capacity);
+
+#if defined(__linux__)
+        madvise(this->data, used_pages, MADV_DONTNEED);
+#elif defined(_WIN32)
+        // Large pages are always resident and can't be reset
+        if (!this->huge_pages_mapped) {
+            VirtualAlloc(this->data, used_pages, MEM_RESET, PAGE_READWRITE);
+        }
+#endif
+
+        if (this->options.prefault) {
+            this->prefault_pages();
+        }
+    }
+
     this->used = 0;
 }
 
@@ -83,4 +212,26 @@ std::size_t ArenaAllocator::capacity_bytes() const {
     return this->capacity;
 }
 
+uint8_t* ArenaAllocator::get_data() const {
+    return this->data;
+}
+
+bool ArenaAllocator::uses_huge_pages() const {
+    return this->huge_pages_mapped;
+}
+
+void ArenaAllocator::prefault_pages() {
+#if defined(__linux__) && defined(MADV_POPULATE_WRITE)
+    if (madvise(this->data, this->capacity, MADV_POPULATE_WRITE) == 0) {
+        return;
+    }
+#endif
+
+    // Touch every page so the OS has to back it with memory now
+    volatile uint8_t* data = this->data;
+    for (std::size_t offset = 0; offset < this->capacity; offset += ARENA_PAGE_SIZE) {
+        data[offset] = 0;
+    }
+}
+
 }
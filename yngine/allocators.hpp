@@ -6,12 +6,32 @@
 #include <utility>
 #include <atomic>
 #include <cstring>
+#include <cassert>
+#include <limits>
 
 namespace Yngine {
 
+enum class HugePages : uint8_t {
+    // Regular pages
+    None,
+    // Ask the OS to back the arena with transparent huge pages where it can
+    Transparent,
+    // Map the arena from the reserved huge page pool, if there aren't enough
+    //   huge pages reserved we fall back to transparent huge pages
+    Explicit,
+};
+
+struct ArenaOptions {
+    HugePages huge_pages = HugePages::Transparent;
+    // Commit all the memory when the arena is created, so searches don't page fault
+    bool prefault = false;
+    // Give the used memory back to the OS when the arena is cleared
+    bool release_on_clear = false;
+};
+
 class ArenaAllocator {
 public:
-    ArenaAllocator(std::size_t capacity);
+    ArenaAllocator(std::size_t capacity, ArenaOptions options = {});
     ~ArenaAllocator();
 
     ArenaAllocator(const ArenaAllocator &) = delete;
@@ -24,13 +44,14 @@ public:
 
     std::size_t used_bytes() const;
     std::size_t capacity_bytes() const;
+    uint8_t* get_data() const;
 
     // Returns the memory for the object without initialization
     template<typename T>
     T* allocate_raw() {
         static_assert(std::is_trivially_destructible_v<T>);
 
-        return static_cast<T*>(this->allocate_aligned(sizeof(T), std::alignment_of_v<T>));
+        return reinterpret_cast<T*>(this->allocate_aligned(sizeof(T), std::alignment_of_v<T>));
     }
 
     // Allocates the object and initializes it with forwarded arguments
@@ -48,74 +69,328 @@ public:
         return result;
     }
 
+    // Whether the arena was mapped from the huge page pool, or transparent huge pages were
+    //   requested while the kernel has them turned on. The kernel can still back parts of
+    //   a transparent arena with regular pages when it finds no free huge pages
+    bool uses_huge_pages() const;
+
 private:
+    void prefault_pages();
+
     uint8_t* data;
     std::atomic<std::size_t> used;
     std::size_t capacity;
+
+    ArenaOptions options;
+    bool huge_pages_mapped;
+
+    // Memory we got from the OS, the data might be aligned inside of it
+    void* mapping;
+    std::size_t mapping_size;
 };
 
+// Pool allocated objects are referred to by 32-bit indices instead of pointers,
+//   index 0 is never handed out so it's used as a null value
+using PoolIndex = uint32_t;
+constexpr PoolIndex POOL_NULL_INDEX = 0;
+
+// The pool hands out fixed size slots from an arena and keeps freed slots in
+//   a shared stack of batches. Threads allocating a lot should go through a
+//   LocalCache, which takes and returns whole batches, so most allocations and
+//   frees don't touch any shared state
 template<typename T>
 class PoolAllocator {
+    // Free slots keep the free list links in their own storage
+    struct FreeSlot {
+        PoolIndex next_free;
+
+        // Only valid for the first slot of a batch
+        PoolIndex next_batch;
+        uint32_t batch_size;
+    };
+
 public:
-    struct Node : public T {
-        using T::T;
+    // Number of slots moved between a local cache and the shared pool at once
+    static constexpr uint32_t BATCH_SIZE = 64;
+
+    class LocalCache {
+    public:
+        LocalCache(PoolAllocator& pool)
+            : pool{pool}
+            , free_head{POOL_NULL_INDEX}
+            , free_count{0}
+            , bump_next{POOL_NULL_INDEX}
+            , bump_end{POOL_NULL_INDEX} {
+        }
+
+        ~LocalCache() {
+            this->flush();
+        }
+
+        LocalCache(const LocalCache &) = delete;
+        LocalCache(LocalCache &&) = delete;
+        LocalCache &operator=(const LocalCache &) = delete;
+        LocalCache &operator=(LocalCache &&) = delete;
+
+        template<typename... Args>
+        T* allocate(Args&&... args) {
+            if (this->free_head == POOL_NULL_INDEX && this->bump_next == this->bump_end) {
+                if (!this->refill()) {
+                    return nullptr;
+                }
+            }
+
+            PoolIndex index;
+            if (this->free_head != POOL_NULL_INDEX) {
+                index = this->free_head;
+                this->free_head = this->pool.free_slot(index)->next_free;
+                this->free_count--;
+            } else {
+                index = this->bump_next++;
+            }
+
+            T* result = new (this->pool.slot(index)) T(std::forward<Args>(args)...);
+
+            return result;
+        }
+
+        void free(T* ptr) {
+            assert(ptr);
+            PoolAllocator::poison(ptr);
+
+            const PoolIndex index = this->pool.index_of(ptr);
+
+            new (ptr) FreeSlot{this->free_head, POOL_NULL_INDEX, 0};
+            this->free_head = index;
+            this->free_count++;
+
+            // Keep one batch for ourselves and give the other one back
+            if (this->free_count == 2 * BATCH_SIZE) {
+                const PoolIndex spilled_head = this->free_head;
 
-        Node* prev_free_node = nullptr;
+                PoolIndex spilled_tail = spilled_head;
+                for (uint32_t i = 1; i < BATCH_SIZE; i++) {
+                    spilled_tail = this->pool.free_slot(spilled_tail)->next_free;
+                }
+
+                this->free_head = this->pool.free_slot(spilled_tail)->next_free;
+                this->free_count -= BATCH_SIZE;
+
+                this->pool.free_slot(spilled_tail)->next_free = POOL_NULL_INDEX;
+                this->pool.push_batch(spilled_head, BATCH_SIZE);
+            }
+        }
+
+        // Returns all cached slots to the shared pool
+        void flush() {
+            // Slots reserved from the arena but never used are returned as free slots
+            for (PoolIndex index = this->bump_next; index != this->bump_end; index++) {
+                new (this->pool.slot(index)) FreeSlot{this->free_head, POOL_NULL_INDEX, 0};
+                this->free_head = index;
+                this->free_count++;
+            }
+
+            this->bump_next = POOL_NULL_INDEX;
+            this->bump_end = POOL_NULL_INDEX;
+
+            if (this->free_head != POOL_NULL_INDEX) {
+                this->pool.push_batch(this->free_head, this->free_count);
+
+                this->free_head = POOL_NULL_INDEX;
+                this->free_count = 0;
+            }
+        }
+
+        PoolAllocator& get_pool() const {
+            return this->pool;
+        }
+
+    private:
+        bool refill() {
+            uint32_t batch_size;
+            const PoolIndex batch = this->pool.pop_batch(batch_size);
+
+            if (batch != POOL_NULL_INDEX) {
+                this->free_head = batch;
+                this->free_count = batch_size;
+                return true;
+            }
+
+            const auto [first_index, count] = this->pool.reserve_slots(BATCH_SIZE);
+            if (count == 0) {
+                return false;
+            }
+
+            this->bump_next = first_index;
+            this->bump_end = first_index + count;
+
+            return true;
+        }
+
+        PoolAllocator& pool;
+
+        PoolIndex free_head;
+        uint32_t free_count;
+
+        // Range of slots reserved from the arena that weren't used yet
+        PoolIndex bump_next;
+        PoolIndex bump_end;
     };
 
-    PoolAllocator(std::size_t capacity)
-        : arena{capacity}
-        , last_free_node{nullptr} {
+    PoolAllocator(std::size_t capacity, ArenaOptions options = {})
+        : arena{capacity, options}
+        , free_batches{0} {
+        static_assert(sizeof(T) >= sizeof(FreeSlot));
+        static_assert(std::is_trivially_destructible_v<T>);
+
+        assert(capacity / sizeof(T) <= std::numeric_limits<PoolIndex>::max());
+
+        // Reserve the slot for the null index
+        this->arena.template allocate_raw<T>();
     }
 
     template<typename... Args>
     T* allocate(Args&&... args) {
-        Node* expected = this->last_free_node.load();
-        Node* desired;
+        uint32_t batch_size;
+        const PoolIndex batch = this->pop_batch(batch_size);
 
-        do {
-            if (expected == nullptr) {
-                return this->arena.template allocate<Node>(std::forward<Args>(args)...);
-            }
-
-            desired = expected->prev_free_node;
-        } while (!this->last_free_node.compare_exchange_weak(expected, desired));
+        if (batch == POOL_NULL_INDEX) {
+            return this->arena.template allocate<T>(std::forward<Args>(args)...);
+        }
 
+        // Take the first slot and put the rest of the batch back
+        const PoolIndex rest = this->free_slot(batch)->next_free;
+        if (rest != POOL_NULL_INDEX) {
+            this->push_batch(rest, batch_size - 1);
+        }
 
-        T* result = new (expected) T(std::forward<Args>(args)...);
+        T* result = new (this->slot(batch)) T(std::forward<Args>(args)...);
 
         return result;
     }
 
     void free(T* ptr) {
         assert(ptr);
-#ifdef DEBUG
-        memset(ptr, 0, sizeof(T));
-#endif
+        PoolAllocator::poison(ptr);
 
-        Node* expected = this->last_free_node.load();
-        Node* desired;
+        new (ptr) FreeSlot{POOL_NULL_INDEX, POOL_NULL_INDEX, 0};
+        this->push_batch(this->index_of(ptr), 1);
+    }
 
-        do {
-            Node* node = static_cast<Node*>(ptr);
-            node->prev_free_node = expected;
+    T* get(PoolIndex index) const {
+        if (index == POOL_NULL_INDEX) {
+            return nullptr;
+        }
 
-            desired = node;
-        } while (!this->last_free_node.compare_exchange_weak(expected, desired));
+        return reinterpret_cast<T*>(this->slot(index));
     }
 
+    PoolIndex index_of(const T* ptr) const {
+        if (!ptr) {
+            return POOL_NULL_INDEX;
+        }
+
+        const auto offset = reinterpret_cast<const uint8_t*>(ptr) - this->arena.get_data();
+        return static_cast<PoolIndex>(offset / sizeof(T));
+    }
+
+    // No local caches should be alive when clearing the pool
     void clear() {
-        this->last_free_node.store(nullptr);
+        this->free_batches.store(0);
         this->arena.clear();
+        this->arena.template allocate_raw<T>();
     }
 
     std::size_t used_bytes() const {
         return this->arena.used_bytes();
     }
 
+    std::size_t capacity_bytes() const {
+        return this->arena.capacity_bytes();
+    }
+
+    bool uses_huge_pages() const {
+        return this->arena.uses_huge_pages();
+    }
+
+    static constexpr std::size_t node_bytes() {
+        return sizeof(T);
+    }
+
 private:
+    static void poison([[maybe_unused]] T* ptr) {
+#ifdef DEBUG
+        memset(ptr, 0, sizeof(T));
+#endif
+    }
+
+    uint8_t* slot(PoolIndex index) const {
+        return this->arena.get_data() + static_cast<std::size_t>(index) * sizeof(T);
+    }
+
+    FreeSlot* free_slot(PoolIndex index) const {
+        return reinterpret_cast<FreeSlot*>(this->slot(index));
+    }
+
+    // The head of the batch stack is tagged with a counter that changes on every
+    // update, so a pop can't succeed on a head that was popped and pushed back
+    static uint64_t pack_head(PoolIndex index, uint32_t tag) {
+        return static_cast<uint64_t>(tag) << 32 | static_cast<uint64_t>(index);
+    }
+
+    void push_batch(PoolIndex first, uint32_t size) {
+        FreeSlot* first_slot = this->free_slot(first);
+        first_slot->batch_size = size;
+
+        uint64_t expected = this->free_batches.load();
+        uint64_t desired;
+
+        do {
+            first_slot->next_batch = static_cast<PoolIndex>(expected);
+            desired = pack_head(first, static_cast<uint32_t>(expected >> 32) + 1);
+        } while (!this->free_batches.compare_exchange_weak(expected, desired));
+    }
+
+    PoolIndex pop_batch(uint32_t& size) {
+        uint64_t expected = this->free_batches.load();
+        uint64_t desired;
+        PoolIndex first;
+
+        do {
+            first = static_cast<PoolIndex>(expected);
+
+            if (first == POOL_NULL_INDEX) {
+                return POOL_NULL_INDEX;
+            }
+
+            desired = pack_head(
+                this->free_slot(first)->next_batch,
+                static_cast<uint32_t>(expected >> 32) + 1
+            );
+        } while (!this->free_batches.compare_exchange_weak(expected, desired));
+
+        size = this->free_slot(first)->batch_size;
+
+        return first;
+    }
+
+    // Returns the first reserved index and the number of reserved slots,
+    //   which is less than requested if the arena is almost full
+    std::pair<PoolIndex, uint32_t> reserve_slots(uint32_t count) {
+        for (; count > 0; count /= 2) {
+            uint8_t* slots = this->arena.allocate_aligned(count * sizeof(T), std::alignment_of_v<T>);
+
+            if (slots) {
+                const auto offset = slots - this->arena.get_data();
+                return std::make_pair(static_cast<PoolIndex>(offset / sizeof(T)), count);
+            }
+        }
+
+        return std::make_pair(POOL_NULL_INDEX, 0u);
+    }
+
     ArenaAllocator arena;
-    std::atomic<Node*> last_free_node;
+    std::atomic<uint64_t> free_batches;
 };
 
 }
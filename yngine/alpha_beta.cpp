@@ -0,0 +1,395 @@
+#include <yngine/alpha_beta.hpp>
+#include <yngine/evaluation.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <vector>
+
+namespace Yngine {
+
+TranspositionTable::TranspositionTable(std::size_t size_bytes) {
+    const std::size_t entry_count = std::bit_floor(std::max<std::size_t>(size_bytes / sizeof(Entry), 1));
+
+    this->entries = std::make_unique<Entry[]>(entry_count);
+    this->mask = entry_count - 1;
+
+    this->clear();
+}
+
+std::optional<TranspositionTable::Data> TranspositionTable::probe(uint64_t key) const {
+    const Entry& entry = this->entries[key & this->mask];
+
+    const auto data = entry.data.load(std::memory_order_relaxed);
+    const auto key_xor_data = entry.key_xor_data.load(std::memory_order_relaxed);
+
+    if ((key_xor_data ^ data) != key) {
+        return std::nullopt;
+    }
+
+    return Data{
+        .move = decode_move(data >> 32),
+        .score = (int16_t)(data >> 16),
+        .depth = (uint8_t)(data >> 8),
+        .bound = (Bound)(data & 0xFF),
+    };
+}
+
+void TranspositionTable::store(uint64_t key, Data data) {
+    Entry& entry = this->entries[key & this->mask];
+
+    const uint64_t packed =
+        ((uint64_t)encode_move(data.move) << 32) |
+        ((uint64_t)(uint16_t)data.score << 16) |
+        ((uint64_t)data.depth << 8) |
+        (uint64_t)data.bound;
+
+    entry.key_xor_data.store(key ^ packed, std::memory_order_relaxed);
+    entry.data.store(packed, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (uint64_t entry_index = 0; entry_index <= this->mask; entry_index++) {
+        // Zero data with the key of zero matches, so the key part can't be zero
+        this->entries[entry_index].key_xor_data.store(1, std::memory_order_relaxed);
+        this->entries[entry_index].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+AlphaBeta::AlphaBeta(std::size_t table_bytes)
+    : board_state{}
+    , table{table_bytes}
+    , best_move{PassMove{}}
+    , best_score{0}
+    , completed_depth{0}
+    , nodes{0} {
+}
+
+AlphaBeta::~AlphaBeta() {
+    this->search_budget.stop();
+    if (this->search_thread.joinable()) {
+        this->search_thread.join();
+    }
+}
+
+std::future<Move> AlphaBeta::search(SearchLimit search_limit, int thread_count) {
+    if (this->search_thread.joinable()) {
+        this->search_thread.join();
+    }
+
+    this->nodes = 0;
+    this->completed_depth = 0;
+    this->best_score = 0;
+
+    MoveList moves_from_root;
+    this->board_state.generate_moves(moves_from_root);
+    if (moves_from_root.get_size() == 1) {
+        std::promise<Move> promise;
+        promise.set_value(moves_from_root[0]);
+        return promise.get_future();
+    }
+
+    this->best_move = moves_from_root[0];
+    this->search_budget.start(search_limit, 0);
+
+    std::packaged_task<Move(AlphaBeta*, int)> task{&AlphaBeta::search_threaded};
+    auto future = task.get_future();
+
+    this->search_thread = std::thread{std::move(task), this, thread_count};
+
+    return future;
+}
+
+void AlphaBeta::stop() {
+    this->search_budget.stop();
+}
+
+void AlphaBeta::apply_move(Move move) {
+    this->board_state.apply_move(move);
+}
+
+void AlphaBeta::set_board(BoardState board) {
+    this->board_state = board;
+}
+
+BoardState AlphaBeta::get_board() const {
+    return this->board_state;
+}
+
+uint64_t AlphaBeta::get_nodes() const {
+    return this->nodes;
+}
+
+int AlphaBeta::get_depth() const {
+    return this->completed_depth;
+}
+
+int AlphaBeta::get_score() const {
+    return this->best_score;
+}
+
+Move AlphaBeta::search_threaded(int thread_count) {
+    std::vector<ThreadState> thread_states(thread_count);
+    std::vector<std::thread> workers;
+
+    for (int thread_index = 0; thread_index < thread_count; thread_index++) {
+        ThreadState& thread_state = thread_states[thread_index];
+        thread_state.thread_index = thread_index;
+        thread_state.nodes = 0;
+        thread_state.claimed_nodes = 0;
+        thread_state.aborted = false;
+        thread_state.history = std::make_unique<int[]>(11*11 * 11*11);
+
+        workers.push_back(std::thread{&AlphaBeta::search_worker, this, std::ref(thread_state)});
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    return this->best_move;
+}
+
+void AlphaBeta::search_worker(ThreadState& thread_state) {
+    constexpr int INFINITE_SCORE = AlphaBeta::WIN_SCORE + 1;
+
+    const bool is_main_thread = thread_state.thread_index == 0;
+
+    BoardState root_board_state = this->board_state;
+    const Color color = root_board_state.whose_move();
+
+    MoveList move_list;
+    root_board_state.generate_moves(move_list);
+
+    for (int depth = 1 + thread_state.thread_index % 2; depth <= AlphaBeta::MAX_DEPTH; depth++) {
+        const auto table_data = this->table.probe(root_board_state.hash());
+        this->order_moves(move_list, table_data ? std::optional{table_data->move} : std::nullopt, thread_state);
+
+        int alpha = -INFINITE_SCORE;
+        Move iteration_best_move = move_list[0];
+
+        for (std::size_t move_index = 0; move_index < move_list.get_size(); move_index++) {
+            const auto move = move_list[move_index];
+            const auto undo = root_board_state.make_move(move);
+
+            int score;
+            if (root_board_state.whose_move() == color) {
+                score = this->negamax(root_board_state, depth - 1, alpha, INFINITE_SCORE, 1, thread_state);
+            } else {
+                score = -this->negamax(root_board_state, depth - 1, -INFINITE_SCORE, -alpha, 1, thread_state);
+            }
+
+            root_board_state.unmake_move(move, undo);
+
+            if (thread_state.aborted) {
+                break;
+            }
+
+            if (score > alpha) {
+                alpha = score;
+                iteration_best_move = move;
+            }
+        }
+
+        // Results of an unfinished iteration can miss the best move
+        if (thread_state.aborted) {
+            break;
+        }
+
+        this->table.store(root_board_state.hash(), TranspositionTable::Data{
+            .move = iteration_best_move,
+            .score = AlphaBeta::score_to_table(alpha, 0),
+            .depth = (uint8_t)depth,
+            .bound = TranspositionTable::Bound::Exact,
+        });
+
+        if (is_main_thread) {
+            this->best_move = iteration_best_move;
+            this->best_score = alpha;
+            this->completed_depth = depth;
+
+            // Deeper searches can't change a proven result
+            if (std::abs(alpha) >= AlphaBeta::WIN_SCORE_THRESHOLD) {
+                break;
+            }
+        }
+    }
+
+    // The other threads only help the main thread, so they stop together with it
+    if (is_main_thread) {
+        this->search_budget.stop();
+    }
+
+    this->nodes += thread_state.nodes;
+}
+
+int AlphaBeta::negamax(BoardState& board_state, int depth, int alpha, int beta, int ply, ThreadState& thread_state) {
+    if (board_state.get_next_action() == NextAction::Done) {
+        const auto result = board_state.game_result();
+        if (result == GameResult::Draw) {
+            return 0;
+        }
+
+        const Color winner = result == GameResult::WhiteWon ? Color::White : Color::Black;
+        return winner == board_state.whose_move() ? AlphaBeta::WIN_SCORE - ply : -(AlphaBeta::WIN_SCORE - ply);
+    }
+
+    if (depth <= 0 || ply >= AlphaBeta::MAX_DEPTH) {
+        return evaluate(board_state);
+    }
+
+    if (!this->claim_node(thread_state)) {
+        thread_state.aborted = true;
+        return 0;
+    }
+
+    const auto key = board_state.hash();
+    std::optional<Move> table_move;
+
+    if (const auto table_data = this->table.probe(key)) {
+        table_move = table_data->move;
+
+        if (table_data->depth >= depth) {
+            const int score = AlphaBeta::score_from_table(table_data->score, ply);
+
+            if (table_data->bound == TranspositionTable::Bound::Exact
+                || (table_data->bound == TranspositionTable::Bound::Lower && score >= beta)
+                || (table_data->bound == TranspositionTable::Bound::Upper && score <= alpha)) {
+                return score;
+            }
+        }
+    }
+
+    MoveList move_list;
+    board_state.generate_moves(move_list);
+    this->order_moves(move_list, table_move, thread_state);
+
+    const Color color = board_state.whose_move();
+    const int original_alpha = alpha;
+
+    int best_score = std::numeric_limits<int>::min();
+    Move best_move = move_list[0];
+
+    for (std::size_t move_index = 0; move_index < move_list.get_size(); move_index++) {
+        const auto move = move_list[move_index];
+
+        // Removals finish the turn of the player who made the row, so they don't use up depth
+        const bool is_removal = std::holds_alternative<RemoveRowMove>(move) || std::holds_alternative<RemoveRingMove>(move);
+        const int child_depth = is_removal ? depth : depth - 1;
+
+        const auto undo = board_state.make_move(move);
+
+        int score;
+        if (board_state.whose_move() == color) {
+            score = this->negamax(board_state, child_depth, alpha, beta, ply + 1, thread_state);
+        } else {
+            score = -this->negamax(board_state, child_depth, -beta, -alpha, ply + 1, thread_state);
+        }
+
+        board_state.unmake_move(move, undo);
+
+        if (thread_state.aborted) {
+            return 0;
+        }
+
+        if (score > best_score) {
+            best_score = score;
+            best_move = move;
+        }
+
+        alpha = std::max(alpha, score);
+
+        if (alpha >= beta) {
+            if (const auto* ring_move = std::get_if<RingMove>(&move)) {
+                thread_state.history[ring_move->from * 11*11 + ring_move->to] += depth * depth;
+            }
+            break;
+        }
+    }
+
+    TranspositionTable::Bound bound = TranspositionTable::Bound::Exact;
+    if (best_score <= original_alpha) {
+        bound = TranspositionTable::Bound::Upper;
+    } else if (best_score >= beta) {
+        bound = TranspositionTable::Bound::Lower;
+    }
+
+    this->table.store(key, TranspositionTable::Data{
+        .move = best_move,
+        .score = AlphaBeta::score_to_table(best_score, ply),
+        .depth = (uint8_t)depth,
+        .bound = bound,
+    });
+
+    return best_score;
+}
+
+void AlphaBeta::order_moves(MoveList& move_list, std::optional<Move> table_move, const ThreadState& thread_state) const {
+    int scores[MOVE_LIST_NUMBER];
+
+    for (std::size_t move_index = 0; move_index < move_list.get_size(); move_index++) {
+        const auto move = move_list[move_index];
+
+        if (table_move && move == *table_move) {
+            scores[move_index] = std::numeric_limits<int>::max();
+        } else if (const auto* ring_move = std::get_if<RingMove>(&move)) {
+            scores[move_index] = thread_state.history[ring_move->from * 11*11 + ring_move->to];
+        } else {
+            scores[move_index] = 0;
+        }
+    }
+
+    // Insertion sort, the lists are short and it keeps the generation order of equal moves
+    for (std::size_t move_index = 1; move_index < move_list.get_size(); move_index++) {
+        const auto move = move_list[move_index];
+        const auto score = scores[move_index];
+
+        std::size_t insert_index = move_index;
+        while (insert_index > 0 && scores[insert_index - 1] < score) {
+            move_list[insert_index] = move_list[insert_index - 1];
+            scores[insert_index] = scores[insert_index - 1];
+            insert_index--;
+        }
+
+        move_list[insert_index] = move;
+        scores[insert_index] = score;
+    }
+}
+
+bool AlphaBeta::claim_node(ThreadState& thread_state) {
+    if (thread_state.claimed_nodes == 0) {
+        thread_state.claimed_nodes = this->search_budget.claim(AlphaBeta::NODE_CHUNK);
+
+        if (thread_state.claimed_nodes == 0) {
+            return false;
+        }
+    }
+
+    thread_state.claimed_nodes--;
+    thread_state.nodes++;
+
+    return true;
+}
+
+// Wins are stored relative to the node, so they are correct wherever the node is found again
+int16_t AlphaBeta::score_to_table(int score, int ply) {
+    if (score >= AlphaBeta::WIN_SCORE_THRESHOLD) {
+        return score + ply;
+    } else if (score <= -AlphaBeta::WIN_SCORE_THRESHOLD) {
+        return score - ply;
+    }
+
+    return score;
+}
+
+int AlphaBeta::score_from_table(int16_t score, int ply) {
+    if (score >= AlphaBeta::WIN_SCORE_THRESHOLD) {
+        return score - ply;
+    } else if (score <= -AlphaBeta::WIN_SCORE_THRESHOLD) {
+        return score + ply;
+    }
+
+    return score;
+}
+
+}
@@ -0,0 +1,116 @@
+#ifndef YNGINE_ALPHA_BETA_HPP
+#define YNGINE_ALPHA_BETA_HPP
+
+#include <yngine/board_state.hpp>
+#include <yngine/mcts.hpp>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
+
+namespace Yngine {
+
+// Hash table shared by all search threads without locks. Every entry stores its key
+//   xored with its data, so an entry torn by two threads writing it at once doesn't match
+class TranspositionTable {
+public:
+    enum class Bound : uint8_t {
+        Exact,
+        Lower,
+        Upper,
+    };
+
+    struct Data {
+        Move move;
+        int16_t score;
+        uint8_t depth;
+        Bound bound;
+    };
+
+    TranspositionTable(std::size_t size_bytes);
+
+    std::optional<Data> probe(uint64_t key) const;
+    void store(uint64_t key, Data data);
+    void clear();
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> key_xor_data;
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    uint64_t mask;
+};
+
+// Alpha-beta search with iterative deepening. All threads search the same position and
+//   share only the hash table (Lazy SMP), the other threads start at odd depths so they
+//   fill the table with different results than the main thread
+class AlphaBeta {
+public:
+    static constexpr int MAX_DEPTH = 64;
+    static constexpr int16_t WIN_SCORE = 30000;
+    // Wins found within this many plies of the root have scores above the threshold
+    static constexpr int16_t WIN_SCORE_THRESHOLD = WIN_SCORE - MAX_DEPTH;
+    // Number of nodes a thread claims from the search budget at once
+    static constexpr int NODE_CHUNK = 1024;
+
+    // Int limits of the search count nodes instead of iterations
+    AlphaBeta(std::size_t table_bytes);
+    ~AlphaBeta();
+
+    AlphaBeta(const AlphaBeta &) = delete;
+    AlphaBeta(AlphaBeta &&) = delete;
+    AlphaBeta &operator=(const AlphaBeta &) = delete;
+    AlphaBeta &operator=(AlphaBeta &&) = delete;
+
+    std::future<Move> search(SearchLimit search_limit, int thread_count);
+    void stop();
+    void apply_move(Move move);
+    void set_board(BoardState board);
+    BoardState get_board() const;
+
+    // Statistics of the last search
+    uint64_t get_nodes() const;
+    int get_depth() const;
+    // Score of the best move for the player to move, in the units of the evaluation
+    int get_score() const;
+
+private:
+    struct ThreadState {
+        int thread_index;
+        uint64_t nodes;
+        // Nodes the thread can still visit from its last claim
+        int claimed_nodes;
+        bool aborted;
+        // Moves which caused cutoffs before are tried first, indexed by the encoded move
+        std::unique_ptr<int[]> history;
+    };
+
+    Move search_threaded(int thread_count);
+    void search_worker(ThreadState& thread_state);
+    int negamax(BoardState& board_state, int depth, int alpha, int beta, int ply, ThreadState& thread_state);
+    void order_moves(MoveList& move_list, std::optional<Move> table_move, const ThreadState& thread_state) const;
+    bool claim_node(ThreadState& thread_state);
+
+    static int16_t score_to_table(int score, int ply);
+    static int score_from_table(int16_t score, int ply);
+
+    BoardState board_state;
+    TranspositionTable table;
+
+    SearchBudget search_budget;
+    std::thread search_thread;
+
+    // Results of the last iteration the main thread finished. The move is only read after the
+    //   workers are joined, the score and the depth by the caller while the search runs
+    Move best_move;
+    std::atomic<int> best_score;
+    std::atomic<int> completed_depth;
+    std::atomic<uint64_t> nodes;
+};
+
+}
+
+#endif // YNGINE_ALPHA_BETA_HPP
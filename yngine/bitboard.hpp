@@ -14,6 +14,7 @@ public:
     Bitboard(__uint128_t n);
 
     operator bool() const;
+    bool operator==(const Bitboard&) const = default;
 
     Bitboard operator~() const;
     Bitboard operator|(Bitboard rhs) const;
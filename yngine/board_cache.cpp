@@ -0,0 +1,81 @@
+#include <yngine/board_cache.hpp>
+
+#include <algorithm>
+
+namespace Yngine {
+
+BoardCache::BoardCache(BoardCacheOptions options)
+    : slot_count{std::max<std::size_t>(options.capacity_bytes / sizeof(Slot), 1)}
+    , epoch{1}
+    , max_depth{std::clamp(options.max_depth, 0, BoardCache::MAX_DEPTH)}
+    , min_simulations{options.min_simulations} {
+    this->slots = std::make_unique<Slot[]>(this->slot_count);
+
+    for (std::size_t i = 0; i < this->slot_count; i++) {
+        this->slots[i].sequence = 0;
+        this->slots[i].node = POOL_NULL_INDEX;
+        this->slots[i].epoch = 0;
+    }
+}
+
+bool BoardCache::load(PoolIndex node, BoardState& board_state) const {
+    const Slot& slot = this->slots[node % this->slot_count];
+
+    const auto sequence = slot.sequence.load(std::memory_order_acquire);
+
+    // Someone is writing into the slot right now
+    if (sequence & 1) {
+        return false;
+    }
+
+    if (slot.node.load(std::memory_order_relaxed) != node
+        || slot.epoch.load(std::memory_order_relaxed) != this->epoch) {
+        return false;
+    }
+
+    const BoardState loaded_board_state = slot.board_state;
+
+    // The slot was overwritten while we were copying it
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+        return false;
+    }
+
+    board_state = loaded_board_state;
+
+    return true;
+}
+
+void BoardCache::store(PoolIndex node, const BoardState& board_state) {
+    Slot& slot = this->slots[node % this->slot_count];
+
+    auto sequence = slot.sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) || !slot.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_relaxed)) {
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.node.store(node, std::memory_order_relaxed);
+    slot.epoch.store(this->epoch, std::memory_order_relaxed);
+    slot.board_state = board_state;
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void BoardCache::invalidate() {
+    this->epoch++;
+}
+
+int BoardCache::get_max_depth() const {
+    return this->max_depth;
+}
+
+uint32_t BoardCache::get_min_simulations() const {
+    return this->min_simulations;
+}
+
+std::size_t BoardCache::memory_bytes() const {
+    return this->slot_count * sizeof(Slot);
+}
+
+}
@@ -0,0 +1,64 @@
+#ifndef YNGINE_BOARD_CACHE_HPP
+#define YNGINE_BOARD_CACHE_HPP
+
+#include <yngine/board_state.hpp>
+#include <yngine/allocators.hpp>
+
+#include <memory>
+
+namespace Yngine {
+
+struct BoardCacheOptions {
+    // Zero disables the cache
+    std::size_t capacity_bytes = 0;
+    // Only nodes up to this depth below the root are cached
+    int max_depth = 8;
+    // Only nodes with at least this many simulations are cached
+    uint32_t min_simulations = 32;
+};
+
+// Board states of the top of the tree, so selection doesn't have to replay all the moves
+//   from the root. Direct mapped by node index, each slot is guarded by a sequence lock,
+//   so lookups and stores from many threads never block
+class BoardCache {
+public:
+    static constexpr int MAX_DEPTH = 16;
+
+    BoardCache(BoardCacheOptions options);
+
+    BoardCache(const BoardCache &) = delete;
+    BoardCache(BoardCache &&) = delete;
+    BoardCache &operator=(const BoardCache &) = delete;
+    BoardCache &operator=(BoardCache &&) = delete;
+
+    // Returns false if the board state of the node isn't cached
+    bool load(PoolIndex node, BoardState& board_state) const;
+    // Might not store the board state if another thread is storing into the same slot
+    void store(PoolIndex node, const BoardState& board_state);
+    // Drops all cached board states, must be called when nodes of the tree could have
+    //   been freed, because their indices are going to be reused
+    void invalidate();
+
+    int get_max_depth() const;
+    uint32_t get_min_simulations() const;
+    std::size_t memory_bytes() const;
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence;
+        std::atomic<PoolIndex> node;
+        std::atomic<uint32_t> epoch;
+        BoardState board_state;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t slot_count;
+
+    uint32_t epoch;
+    const int max_depth;
+    const uint32_t min_simulations;
+};
+
+}
+
+#endif // YNGINE_BOARD_CACHE_HPP
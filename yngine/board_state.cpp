@@ -1,7 +1,9 @@
 #include <yngine/board_state.hpp>
 #include <yngine/tables.hpp>
+#include <yngine/symmetry.hpp>
 
 #include <cassert>
+#include <tuple>
 
 namespace Yngine {
 
@@ -159,15 +161,240 @@ void BoardState::apply_move(Move move) {
 
             this->last_ring_move_color = opposite(this->last_ring_move_color);
         },
+        [this](RemoveRowAndRingMove move) {
+            this->apply_move(RemoveRowMove{move.from, move.direction});
+            this->apply_move(RemoveRingMove{move.ring});
+        },
     }, move);
 }
 
+void BoardState::generate_compound_moves(MoveList& move_list) const {
+    if (this->next_action != NextAction::RowRemoval) {
+        this->generate_moves(move_list);
+        return;
+    }
+
+    MoveList rows;
+    this->generate_row_removal(rows);
+
+    MoveList rings;
+    this->generate_ring_removal(rings);
+
+    for (std::size_t row_index = 0; row_index < rows.get_size(); row_index++) {
+        const auto row = std::get<RemoveRowMove>(rows[row_index]);
+
+        for (std::size_t ring_index = 0; ring_index < rings.get_size(); ring_index++) {
+            const auto ring = std::get<RemoveRingMove>(rings[ring_index]);
+
+            move_list.append(RemoveRowAndRingMove{row.from, row.direction, ring.index});
+        }
+    }
+
+    assert(move_list.get_size() != 0);
+}
+
+void BoardState::apply_compound_move(Move move) {
+    this->apply_move(move);
+
+    // Only removals are checked, finding out that a player has to pass would cost
+    // a full ring move generation after every move
+    while (this->next_action == NextAction::RowRemoval || this->next_action == NextAction::RingRemoval) {
+        MoveList move_list;
+        this->generate_compound_moves(move_list);
+
+        if (move_list.get_size() != 1) {
+            break;
+        }
+
+        this->apply_move(move_list[0]);
+    }
+}
+
 BoardState BoardState::with_move(Move move) const {
     auto board_copy = *this;
     board_copy.apply_move(move);
     return board_copy;
 }
 
+MoveUndo BoardState::make_move(Move move) {
+    const MoveUndo undo{
+        .next_action = this->next_action,
+        .ring_and_row_removal_color = this->ring_and_row_removal_color,
+        .last_ring_move_color = this->last_ring_move_color,
+        .last_ring_move = this->last_ring_move,
+    };
+
+    this->apply_move(move);
+
+    return undo;
+}
+
+void BoardState::unmake_move(Move move, MoveUndo undo) {
+    std::visit(variant_overloaded{
+        [this, undo](PlaceRingMove move) {
+            if (undo.last_ring_move_color == Color::Black) {
+                this->white_rings.clear_bit(move.index);
+            } else {
+                this->black_rings.clear_bit(move.index);
+            }
+        },
+        [this, undo](RingMove move) {
+            // Flipping the same nodes again restores their colors, because
+            // the flipped markers are exactly the markers on those nodes
+            const auto direction_num = static_cast<uint8_t>(move.direction);
+            const auto flipped_nodes =
+                TABLE_RAYS[move.from][direction_num] & ~TABLE_RAYS[move.to][direction_num];
+
+            const auto black_markers_to_flip = this->black_markers & flipped_nodes;
+            const auto white_markers_to_flip = this->white_markers & flipped_nodes;
+
+            this->white_markers &= ~flipped_nodes;
+            this->black_markers &= ~flipped_nodes;
+
+            this->white_markers |= black_markers_to_flip;
+            this->black_markers |= white_markers_to_flip;
+
+            if (undo.last_ring_move_color == Color::Black) {
+                this->white_rings.clear_bit(move.to);
+                this->white_rings.set_bit(move.from);
+                this->white_markers.clear_bit(move.from);
+            } else {
+                this->black_rings.clear_bit(move.to);
+                this->black_rings.set_bit(move.from);
+                this->black_markers.clear_bit(move.from);
+            }
+        },
+        [this, undo](RemoveRowMove move) {
+            const auto removed_markers = BoardState::line_in_direction(move.from, move.direction, 5);
+
+            if (undo.ring_and_row_removal_color == Color::White) {
+                this->white_markers |= removed_markers;
+            } else {
+                this->black_markers |= removed_markers;
+            }
+        },
+        [this, undo](RemoveRingMove move) {
+            if (undo.ring_and_row_removal_color == Color::White) {
+                this->white_rings.set_bit(move.index);
+            } else {
+                this->black_rings.set_bit(move.index);
+            }
+        },
+        [](PassMove) {
+        },
+        [this, undo](RemoveRowAndRingMove move) {
+            this->unmake_move(RemoveRingMove{move.ring}, undo);
+            this->unmake_move(RemoveRowMove{move.from, move.direction}, undo);
+        },
+    }, move);
+
+    this->next_action = undo.next_action;
+    this->ring_and_row_removal_color = undo.ring_and_row_removal_color;
+    this->last_ring_move_color = undo.last_ring_move_color;
+    this->last_ring_move = undo.last_ring_move;
+}
+
+// Finalizer of splitmix64
+static uint64_t mix_hash(uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+uint64_t BoardState::hash() const {
+    const Bitboard bitboards[] = {
+        this->white_rings, this->black_rings, this->white_markers, this->black_markers,
+    };
+
+    uint64_t result = mix_hash(
+        (uint64_t)this->next_action |
+        ((uint64_t)this->ring_and_row_removal_color << 8) |
+        ((uint64_t)this->last_ring_move_color << 16) |
+        ((uint64_t)encode_move(this->last_ring_move) << 24)
+    );
+
+    for (const auto bitboard : bitboards) {
+        const auto bits = bitboard.get_bits();
+        result = mix_hash(result ^ (uint64_t)bits);
+        result = mix_hash(result ^ (uint64_t)(bits >> 64));
+    }
+
+    return result;
+}
+
+BoardState BoardState::transformed(uint8_t symmetry) const {
+    BoardState result = *this;
+
+    result.white_rings = transform_bitboard(this->white_rings, symmetry);
+    result.black_rings = transform_bitboard(this->black_rings, symmetry);
+    result.white_markers = transform_bitboard(this->white_markers, symmetry);
+    result.black_markers = transform_bitboard(this->black_markers, symmetry);
+
+    // No ring move was made yet
+    if (this->last_ring_move.from != 0) {
+        result.last_ring_move = std::get<RingMove>(transform_move(this->last_ring_move, symmetry));
+    }
+
+    return result;
+}
+
+std::pair<BoardState, uint8_t> BoardState::canonical() const {
+    BoardState canonical_board_state = *this;
+    uint8_t canonical_symmetry = SYMMETRY_IDENTITY;
+
+    for (uint8_t symmetry = 1; symmetry < SYMMETRY_COUNT; symmetry++) {
+        const auto transformed_board_state = this->transformed(symmetry);
+
+        if (transformed_board_state.is_oriented_before(canonical_board_state)) {
+            canonical_board_state = transformed_board_state;
+            canonical_symmetry = symmetry;
+        }
+    }
+
+    return std::make_pair(canonical_board_state, canonical_symmetry);
+}
+
+void BoardState::remove_symmetric_moves(MoveList& move_list) const {
+    BoardState kept_positions[MOVE_LIST_NUMBER];
+    std::size_t kept_count = 0;
+
+    for (std::size_t move_index = 0; move_index < move_list.get_size(); move_index++) {
+        const auto position = this->with_move(move_list[move_index]).canonical().first;
+
+        bool is_symmetric = false;
+        for (std::size_t kept_index = 0; kept_index < kept_count; kept_index++) {
+            if (kept_positions[kept_index] == position) {
+                is_symmetric = true;
+                break;
+            }
+        }
+
+        if (!is_symmetric) {
+            move_list[kept_count] = move_list[move_index];
+            kept_positions[kept_count] = position;
+            kept_count++;
+        }
+    }
+
+    move_list.resize(kept_count);
+}
+
+bool BoardState::is_oriented_before(const BoardState& other) const {
+    const auto key = [](const BoardState& board_state) {
+        return std::make_tuple(
+            board_state.white_rings.get_bits(),
+            board_state.black_rings.get_bits(),
+            board_state.white_markers.get_bits(),
+            board_state.black_markers.get_bits(),
+            board_state.last_ring_move.from,
+            board_state.last_ring_move.to,
+            board_state.last_ring_move.direction
+        );
+    };
+
+    return key(*this) < key(other);
+}
+
 void BoardState::playout(XoshiroCpp::Xoshiro256StarStar& prng) {
     MoveList move_list;
     while (this->next_action != NextAction::Done) {
@@ -216,6 +443,37 @@ Color BoardState::whose_move() const {
     }
 }
 
+Bitboard BoardState::get_rings(Color color) const {
+    return color == Color::White ? this->white_rings : this->black_rings;
+}
+
+Bitboard BoardState::get_markers(Color color) const {
+    return color == Color::White ? this->white_markers : this->black_markers;
+}
+
+bool BoardState::is_valid() const {
+    if (this->next_action > NextAction::Done
+        || this->ring_and_row_removal_color > Color::Black
+        || this->last_ring_move_color > Color::Black) {
+        return false;
+    }
+
+    // A move from index 0 means no ring move was made yet
+    if (this->last_ring_move.from != 0
+        && (!Bitboard::is_index_in_game(this->last_ring_move.from)
+            || !Bitboard::is_index_in_game(this->last_ring_move.to)
+            || static_cast<uint8_t>(this->last_ring_move.direction) >= 6)) {
+        return false;
+    }
+
+    const Bitboard off_board = ~Bitboard::get_game_board();
+
+    return !(this->white_rings & off_board)
+        && !(this->black_rings & off_board)
+        && !(this->white_markers & off_board)
+        && !(this->black_markers & off_board);
+}
+
 void BoardState::generate_ring_placement_moves(MoveList& move_list) const {
     Bitboard occupancy = this->white_rings | this->black_rings;
     Bitboard empty_nodes = ~occupancy & Bitboard::get_game_board();
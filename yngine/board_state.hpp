@@ -18,6 +18,14 @@ enum class NextAction : uint8_t {
     Done,
 };
 
+// Everything unmake_move needs that it can't derive from the move itself
+struct MoveUndo {
+    NextAction next_action;
+    Color ring_and_row_removal_color;
+    Color last_ring_move_color;
+    RingMove last_ring_move;
+};
+
 class BoardState {
 public:
     BoardState();
@@ -26,12 +34,40 @@ public:
     void generate_moves(MoveList& move_list) const;
     void apply_move(Move move);
     BoardState with_move(Move move) const;
+    // Same as apply_move, but the move can be taken back with unmake_move without copying the board
+    MoveUndo make_move(Move move);
+    // Must be called with the last made move and what making it returned
+    void unmake_move(Move move, MoveUndo undo);
+
+    // Same as generate_moves, except that a row removal is generated together with
+    //   the following ring removal as a RemoveRowAndRingMove
+    void generate_compound_moves(MoveList& move_list) const;
+    // Applies the move and then all removals that are forced because there's only one option
+    void apply_compound_move(Move move);
+
+    bool operator==(const BoardState&) const = default;
+    uint64_t hash() const;
+
+    BoardState transformed(uint8_t symmetry) const;
+    // Returns the orientation of the position that is the smallest of all of its
+    //   symmetric orientations, and the symmetry which transforms the position into it
+    std::pair<BoardState, uint8_t> canonical() const;
+    // Keeps only the first of the moves that lead to symmetric positions
+    void remove_symmetric_moves(MoveList& move_list) const;
 
     void playout(XoshiroCpp::Xoshiro256StarStar& prng);
 
     NextAction get_next_action() const;
     GameResult game_result() const;
     Color whose_move() const;
+    Bitboard get_rings(Color color) const;
+    Bitboard get_markers(Color color) const;
+    // Returns the color of the player who has to remove a row after the ring move,
+    //   which has to be the last move applied to the board
+    std::optional<Color> check_rows(RingMove last_move) const;
+    // Whether the fields hold values the engine can work with, for states read from files:
+    //   known actions and colors, and rings and markers only on nodes of the board
+    bool is_valid() const;
 
     friend std::ostream& operator<<(std::ostream& out, BoardState board_state);
 
@@ -40,7 +76,8 @@ private:
     void generate_ring_moves(MoveList& move_list) const;
     void generate_row_removal(MoveList& move_list) const;
     void generate_ring_removal(MoveList& move_list) const;
-    std::optional<Color> check_rows(RingMove last_move) const;
+    // Orders positions which differ only in their orientation
+    bool is_oriented_before(const BoardState& other) const;
 
     static uint8_t length_of_row(Bitboard bitboard, uint8_t index, Direction direction);
     static Bitboard line_in_direction(uint8_t index, Direction direction, uint8_t length);
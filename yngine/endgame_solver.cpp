@@ -0,0 +1,241 @@
+#include <yngine/endgame_solver.hpp>
+#include <yngine/tables.hpp>
+
+#include <algorithm>
+#include <bit>
+
+namespace Yngine {
+
+EndgameSolver::EndgameSolver(EndgameSolverOptions options)
+    : options{options}
+    , nodes{0}
+    , deadline{std::chrono::steady_clock::time_point::max()}
+    , out_of_nodes{false} {
+    const std::size_t entry_count = std::bit_floor(std::max<std::size_t>(options.table_bytes / sizeof(Entry), 1));
+
+    this->table.resize(entry_count, Entry{});
+    this->table_mask = entry_count - 1;
+}
+
+bool EndgameSolver::is_endgame(const BoardState& board_state) const {
+    const auto next_action = board_state.get_next_action();
+    if (next_action == NextAction::RingPlacement || next_action == NextAction::Done) {
+        return false;
+    }
+
+    const auto markers_left = 51 -
+        board_state.get_markers(Color::White).popcount() -
+        board_state.get_markers(Color::Black).popcount();
+
+    if (markers_left <= this->options.max_markers_left) {
+        return true;
+    }
+
+    return this->options.solve_last_rows
+        && board_state.get_rings(Color::White).popcount() == 3
+        && board_state.get_rings(Color::Black).popcount() == 3;
+}
+
+EndgameSolver::Result EndgameSolver::solve(BoardState board_state, std::chrono::steady_clock::time_point deadline) {
+    this->nodes = 0;
+    this->deadline = deadline;
+    this->out_of_nodes = false;
+
+    const Color color = board_state.whose_move();
+    const auto key = board_state.hash();
+
+    int depth = 1;
+    for (; depth <= EndgameSolver::MAX_DEPTH; depth++) {
+        const auto bounds = this->search(board_state, depth, -1, 1);
+
+        if (this->out_of_nodes) {
+            break;
+        }
+
+        if (bounds.lower != bounds.upper) {
+            continue;
+        }
+
+        // The root is stored last, so its entry is still there unless the position is over
+        const Entry& entry = this->table[key & this->table_mask];
+        if (entry.key != key) {
+            break;
+        }
+
+        GameResult result = GameResult::Draw;
+        if (bounds.lower != 0) {
+            const Color winner = bounds.lower > 0 ? color : opposite(color);
+            result = winner == Color::White ? GameResult::WhiteWon : GameResult::BlackWon;
+        }
+
+        return Result{
+            .result = result,
+            .best_move = decode_move(entry.best_move),
+            .depth = depth,
+            .nodes = this->nodes,
+        };
+    }
+
+    return Result{
+        .result = std::nullopt,
+        .best_move = std::nullopt,
+        .depth = depth - 1,
+        .nodes = this->nodes,
+    };
+}
+
+EndgameSolver::Bounds EndgameSolver::search(BoardState& board_state, int depth, int alpha, int beta) {
+    if (board_state.get_next_action() == NextAction::Done) {
+        const auto value = EndgameSolver::terminal_value(board_state);
+        return Bounds{value, value};
+    }
+
+    if (depth == 0 || this->out_of_nodes) {
+        return Bounds{-1, 1};
+    }
+
+    if (++this->nodes > this->options.max_nodes) {
+        this->out_of_nodes = true;
+        return Bounds{-1, 1};
+    }
+
+    if (this->nodes % EndgameSolver::DEADLINE_CHECK_NODES == 0 && std::chrono::steady_clock::now() >= this->deadline) {
+        this->out_of_nodes = true;
+        return Bounds{-1, 1};
+    }
+
+    // Bounds don't depend on the depth they were found at, shallower entries only
+    //   have to be searched again if they are too wide to be of any use here
+    const auto key = board_state.hash();
+    Entry& entry = this->table[key & this->table_mask];
+
+    Bounds known_bounds{-1, 1};
+    std::optional<Move> table_move;
+
+    if (entry.key == key) {
+        known_bounds = entry.bounds;
+        table_move = decode_move(entry.best_move);
+
+        if (known_bounds.lower == known_bounds.upper
+            || known_bounds.lower >= beta
+            || known_bounds.upper <= alpha
+            || entry.depth >= depth) {
+            return known_bounds;
+        }
+    }
+
+    MoveList move_list;
+    board_state.generate_moves(move_list);
+    this->order_moves(board_state, move_list, table_move);
+
+    const Color color = board_state.whose_move();
+
+    // The value is the best of the values of the children, so are both of the bounds
+    Bounds bounds{-1, -1};
+    Move best_move = move_list[0];
+    Bounds best_child_bounds{-1, -1};
+
+    for (std::size_t move_index = 0; move_index < move_list.get_size(); move_index++) {
+        const auto move = move_list[move_index];
+        const auto undo = board_state.make_move(move);
+
+        // Removals can give the next move to the same player
+        Bounds child_bounds;
+        if (board_state.whose_move() == color) {
+            child_bounds = this->search(board_state, depth - 1, std::max<int>(alpha, bounds.lower), beta);
+        } else {
+            const auto opponent_bounds = this->search(board_state, depth - 1, -beta, -std::max<int>(alpha, bounds.lower));
+            child_bounds = Bounds{(int8_t)-opponent_bounds.upper, (int8_t)-opponent_bounds.lower};
+        }
+
+        board_state.unmake_move(move, undo);
+
+        if (move_index == 0
+            || child_bounds.lower > best_child_bounds.lower
+            || (child_bounds.lower == best_child_bounds.lower && child_bounds.upper > best_child_bounds.upper)) {
+            best_move = move;
+            best_child_bounds = child_bounds;
+        }
+
+        bounds.lower = std::max(bounds.lower, child_bounds.lower);
+        bounds.upper = std::max(bounds.upper, child_bounds.upper);
+
+        // Moves we don't search could be better than all of the searched ones
+        if (bounds.lower >= beta || this->out_of_nodes) {
+            if (move_index + 1 < move_list.get_size()) {
+                bounds.upper = 1;
+            }
+            break;
+        }
+    }
+
+    bounds.lower = std::max(bounds.lower, known_bounds.lower);
+    bounds.upper = std::min(bounds.upper, known_bounds.upper);
+
+    // An unfinished search would store bounds that are only as wide as they are because of it
+    if (!this->out_of_nodes) {
+        entry = Entry{
+            .key = key,
+            .bounds = bounds,
+            .depth = (uint8_t)depth,
+            .padding = 0,
+            .best_move = encode_move(best_move),
+        };
+    }
+
+    return bounds;
+}
+
+void EndgameSolver::order_moves(const BoardState& board_state, MoveList& move_list, std::optional<Move> table_move) const {
+    const Color color = board_state.whose_move();
+    const auto our_markers = board_state.get_markers(color);
+    const auto their_markers = board_state.get_markers(opposite(color));
+
+    int scores[MOVE_LIST_NUMBER];
+
+    for (std::size_t move_index = 0; move_index < move_list.get_size(); move_index++) {
+        const auto move = move_list[move_index];
+        int score = 0;
+
+        if (table_move && move == *table_move) {
+            score = 1000;
+        } else if (const auto* ring_move = std::get_if<RingMove>(&move)) {
+            // Moves that flip more of the markers of the opponent to our color come first
+            const auto direction_num = static_cast<uint8_t>(ring_move->direction);
+            const auto flipped_nodes =
+                TABLE_RAYS[ring_move->from][direction_num] & ~TABLE_RAYS[ring_move->to][direction_num];
+
+            score = (their_markers & flipped_nodes).popcount() - (our_markers & flipped_nodes).popcount();
+        }
+
+        scores[move_index] = score;
+    }
+
+    // Insertion sort, the lists are short and it keeps the generation order of equal moves
+    for (std::size_t move_index = 1; move_index < move_list.get_size(); move_index++) {
+        const auto move = move_list[move_index];
+        const auto score = scores[move_index];
+
+        std::size_t insert_index = move_index;
+        while (insert_index > 0 && scores[insert_index - 1] < score) {
+            move_list[insert_index] = move_list[insert_index - 1];
+            scores[insert_index] = scores[insert_index - 1];
+            insert_index--;
+        }
+
+        move_list[insert_index] = move;
+        scores[insert_index] = score;
+    }
+}
+
+int8_t EndgameSolver::terminal_value(const BoardState& board_state) {
+    const auto result = board_state.game_result();
+    if (result == GameResult::Draw) {
+        return 0;
+    }
+
+    const Color winner = result == GameResult::WhiteWon ? Color::White : Color::Black;
+    return winner == board_state.whose_move() ? 1 : -1;
+}
+
+}
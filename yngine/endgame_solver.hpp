@@ -0,0 +1,79 @@
+#ifndef YNGINE_ENDGAME_SOLVER_HPP
+#define YNGINE_ENDGAME_SOLVER_HPP
+
+#include <yngine/board_state.hpp>
+
+#include <chrono>
+#include <vector>
+
+namespace Yngine {
+
+struct EndgameSolverOptions {
+    // Zero disables the solver
+    std::size_t table_bytes = 0;
+    // Positions with at most this many markers left to place are solved
+    int max_markers_left = 6;
+    // Positions where both players are one row away from winning are solved too
+    bool solve_last_rows = true;
+    // Nodes one solve can visit before giving up, searches limited by time also give up
+    //   at the deadline of the search
+    uint64_t max_nodes = 50'000;
+};
+
+// Exact alpha-beta search of the end of the game with iterative deepening.
+//   Positions that can't be searched to the end of the game in time stay unproven
+class EndgameSolver {
+public:
+    static constexpr int MAX_DEPTH = 64;
+    // Number of nodes between two reads of the clock
+    static constexpr uint64_t DEADLINE_CHECK_NODES = 1024;
+
+    struct Result {
+        // From the point of view of the game, empty if the solver ran out of nodes or time
+        std::optional<GameResult> result;
+        // Only set if the result is proven
+        std::optional<Move> best_move;
+        int depth;
+        uint64_t nodes;
+    };
+
+    EndgameSolver(EndgameSolverOptions options);
+
+    bool is_endgame(const BoardState& board_state) const;
+    Result solve(BoardState board_state, std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+private:
+    // Bounds of the value of a position for the player to move, the value is
+    //   one for a win, zero for a draw and minus one for a loss
+    struct Bounds {
+        int8_t lower;
+        int8_t upper;
+    };
+
+    struct Entry {
+        uint64_t key;
+        Bounds bounds;
+        uint8_t depth;
+        uint8_t padding;
+        uint32_t best_move;
+    };
+
+    Bounds search(BoardState& board_state, int depth, int alpha, int beta);
+    // Puts the most promising moves first, the move from the table before all of them
+    void order_moves(const BoardState& board_state, MoveList& move_list, std::optional<Move> table_move) const;
+    static int8_t terminal_value(const BoardState& board_state);
+
+    std::vector<Entry> table;
+    uint64_t table_mask;
+
+    const EndgameSolverOptions options;
+
+    uint64_t nodes;
+    std::chrono::steady_clock::time_point deadline;
+    // Set once either the nodes or the time of the solve are used up
+    bool out_of_nodes;
+};
+
+}
+
+#endif // YNGINE_ENDGAME_SOLVER_HPP
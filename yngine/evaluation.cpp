@@ -0,0 +1,81 @@
+#include <yngine/evaluation.hpp>
+#include <yngine/tables.hpp>
+
+#include <bit>
+
+namespace Yngine {
+
+static int popcount(__uint128_t bits) {
+    return std::popcount((uint64_t)bits) + std::popcount((uint64_t)(bits >> 64));
+}
+
+RowThreats count_row_threats(Bitboard markers, Bitboard other_markers) {
+    // Steps between the indices of neighbouring nodes along the SE, NE and N axes
+    constexpr int AXIS_STEPS[3] = {1, 11, 10};
+
+    const auto own = markers.get_bits();
+    const auto other = other_markers.get_bits();
+
+    RowThreats threats{0, 0};
+
+    for (int axis = 0; axis < 3; axis++) {
+        const int step = AXIS_STEPS[axis];
+
+        // Bit k of the window starting at a node is moved onto that node
+        const __uint128_t m0 = own;
+        const __uint128_t m1 = own >> step;
+        const __uint128_t m2 = own >> (2 * step);
+        const __uint128_t m3 = own >> (3 * step);
+        const __uint128_t m4 = own >> (4 * step);
+
+        const __uint128_t blocked =
+            other | (other >> step) | (other >> (2 * step)) | (other >> (3 * step)) | (other >> (4 * step));
+
+        // Two full adders and a half adder give the count of markers in every window in bits
+        const __uint128_t sum_a = m0 ^ m1 ^ m2;
+        const __uint128_t carry_a = (m0 & m1) | (m2 & (m0 ^ m1));
+        const __uint128_t ones = m3 ^ m4 ^ sum_a;
+        const __uint128_t carry_b = (m3 & m4) | (sum_a & (m3 ^ m4));
+        const __uint128_t twos = carry_a ^ carry_b;
+        const __uint128_t fours = carry_a & carry_b;
+
+        const __uint128_t open_windows = TABLE_ROW_WINDOW_STARTS[axis].get_bits() & ~blocked;
+
+        threats.threes += popcount(open_windows & ~fours & twos & ones);
+        threats.fours += popcount(open_windows & fours & ~twos & ~ones);
+    }
+
+    return threats;
+}
+
+int evaluate(const BoardState& board_state) {
+    const auto next_action = board_state.get_next_action();
+    if (next_action == NextAction::RingPlacement) {
+        return 0;
+    }
+
+    const Color color = board_state.whose_move();
+    const Color other_color = opposite(color);
+
+    const auto our_markers = board_state.get_markers(color);
+    const auto their_markers = board_state.get_markers(other_color);
+
+    // Each player has removed as many rings as they have less of them than 5
+    int rings = board_state.get_rings(other_color).popcount() - board_state.get_rings(color).popcount();
+
+    // The player removing a row is about to remove one of their rings too
+    if (next_action == NextAction::RowRemoval || next_action == NextAction::RingRemoval) {
+        rings++;
+    }
+
+    const auto our_threats = count_row_threats(our_markers, their_markers);
+    const auto their_threats = count_row_threats(their_markers, our_markers);
+
+    return
+        EVALUATION_RING_WEIGHT * rings +
+        EVALUATION_FOUR_WEIGHT * (our_threats.fours - their_threats.fours) +
+        EVALUATION_THREE_WEIGHT * (our_threats.threes - their_threats.threes) +
+        EVALUATION_MARKER_WEIGHT * (our_markers.popcount() - their_markers.popcount());
+}
+
+}
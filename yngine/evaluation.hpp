@@ -0,0 +1,29 @@
+#ifndef YNGINE_EVALUATION_HPP
+#define YNGINE_EVALUATION_HPP
+
+#include <yngine/board_state.hpp>
+
+namespace Yngine {
+
+constexpr int EVALUATION_RING_WEIGHT = 1000;
+constexpr int EVALUATION_FOUR_WEIGHT = 60;
+constexpr int EVALUATION_THREE_WEIGHT = 20;
+constexpr int EVALUATION_MARKER_WEIGHT = 3;
+
+// Number of places where the markers of one color could complete a row, which are
+//   5 nodes in a row with no markers of the other color and 3 or 4 of this color
+struct RowThreats {
+    int threes;
+    int fours;
+};
+
+// Counts the windows of all nodes of an axis at once with bit sliced adders on whole bitboards
+RowThreats count_row_threats(Bitboard markers, Bitboard other_markers);
+
+// Static evaluation for the player to move, positive is better for them. Counts removed rings,
+//   rows the players can complete and markers on the board. Positions of the ring placement are even
+int evaluate(const BoardState& board_state);
+
+}
+
+#endif // YNGINE_EVALUATION_HPP
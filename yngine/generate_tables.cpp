@@ -53,6 +53,156 @@ void generate_rays_tables(std::ofstream& output) {
     output << "};\n\n";
 }
 
+// Nodes where 5 nodes in a row along one of the 3 axes start, so the row lies completely
+// on the board. Rows along the other 3 directions are the same rows started from their end
+void generate_row_window_tables(std::ofstream& output) {
+    output << "const Bitboard TABLE_ROW_WINDOW_STARTS[3] = {\n";
+
+    for (int dir_index = 0; dir_index < 3; dir_index++) {
+        const auto dir = direction_to_vec2[dir_index];
+
+        Bitboard starts{};
+
+        for (int index = 0; index < 11*11; index++) {
+            if (!Bitboard::is_index_in_game(index)) {
+                continue;
+            }
+
+            const auto position = Bitboard::index_to_coords(index);
+
+            bool is_row_in_game = true;
+            for (int step = 1; step < 5; step++) {
+                const uint8_t x = position.first + step * dir.first;
+                const uint8_t y = position.second + step * dir.second;
+
+                if (!Bitboard::are_coords_in_game(x, y)) {
+                    is_row_in_game = false;
+                    break;
+                }
+            }
+
+            if (is_row_in_game) {
+                starts.set_bit(index);
+            }
+        }
+
+        const auto result_bits = starts.get_bits();
+        const uint64_t low  = result_bits;
+        const uint64_t high = result_bits >> 64;
+
+        const auto save_flags{output.flags()};
+
+        output <<
+            "    Bitboard{((__uint128_t)0x" <<
+            std::hex << std::uppercase <<
+            high << " << 64) | 0x" << low << "},\n";
+
+        output.flags(save_flags);
+    }
+
+    output << "};\n\n";
+}
+
+// The 12 symmetries of the board are the 6 rotations around the center, each of
+// them optionally preceded by the reflection that swaps the x and y axes
+std::pair<int, int> apply_symmetry(int symmetry, int q, int r) {
+    if (symmetry >= 6) {
+        std::swap(q, r);
+    }
+
+    // Rotation by 60 degrees maps the direction (1, 0) to (0, 1) and (0, 1) to (-1, 1)
+    for (int rotation = 0; rotation < symmetry % 6; rotation++) {
+        const int new_q = -r;
+        const int new_r = q + r;
+
+        q = new_q;
+        r = new_r;
+    }
+
+    return std::make_pair(q, r);
+}
+
+void generate_symmetry_tables(std::ofstream& output) {
+    constexpr int SYMMETRY_COUNT = 12;
+    constexpr int CENTER = 5;
+
+    uint8_t indices[SYMMETRY_COUNT][11*11];
+
+    output << "const uint8_t TABLE_SYMMETRY_INDICES[" << SYMMETRY_COUNT << "][121] = {\n";
+
+    for (int symmetry = 0; symmetry < SYMMETRY_COUNT; symmetry++) {
+        output << "    {";
+
+        for (int index = 0; index < 11*11; index++) {
+            // Indices outside of the game board are mapped to themselves
+            indices[symmetry][index] = index;
+
+            if (Bitboard::is_index_in_game(index)) {
+                const auto [x, y] = Bitboard::index_to_coords(index);
+                const auto [q, r] = apply_symmetry(symmetry, x - CENTER, y - CENTER);
+
+                if (!Bitboard::are_coords_in_game(q + CENTER, r + CENTER)) {
+                    std::cerr << "Symmetry " << symmetry << " maps a node outside of the board" << std::endl;
+                    std::exit(1);
+                }
+
+                indices[symmetry][index] = Bitboard::coords_to_index(q + CENTER, r + CENTER);
+            }
+
+            output << (index % 11 == 0 ? "\n        " : " ") << (int)indices[symmetry][index] << ",";
+        }
+
+        output << "\n    },\n";
+    }
+
+    output << "};\n\n";
+
+    output << "const Direction TABLE_SYMMETRY_DIRECTIONS[" << SYMMETRY_COUNT << "][6] = {\n";
+
+    for (int symmetry = 0; symmetry < SYMMETRY_COUNT; symmetry++) {
+        output << "    {";
+
+        for (int dir_index = 0; dir_index < 6; dir_index++) {
+            const auto dir = direction_to_vec2[dir_index];
+            const auto [q, r] = apply_symmetry(symmetry, (int8_t)dir.first, (int8_t)dir.second);
+
+            for (int new_dir_index = 0; new_dir_index < 6; new_dir_index++) {
+                const auto new_dir = direction_to_vec2[new_dir_index];
+
+                if ((int8_t)new_dir.first == q && (int8_t)new_dir.second == r) {
+                    output << " Direction{" << new_dir_index << "},";
+                }
+            }
+        }
+
+        output << " },\n";
+    }
+
+    output << "};\n\n";
+
+    output << "const uint8_t TABLE_SYMMETRY_INVERSES[" << SYMMETRY_COUNT << "] = {";
+
+    for (int symmetry = 0; symmetry < SYMMETRY_COUNT; symmetry++) {
+        for (int inverse = 0; inverse < SYMMETRY_COUNT; inverse++) {
+            bool is_inverse = true;
+
+            for (int index = 0; index < 11*11; index++) {
+                if (indices[inverse][indices[symmetry][index]] != index) {
+                    is_inverse = false;
+                    break;
+                }
+            }
+
+            if (is_inverse) {
+                output << " " << inverse << ",";
+                break;
+            }
+        }
+    }
+
+    output << " };\n\n";
+}
+
 int main(int argc, const char** argv) {
     if (argc != 2) {
         std::cerr <<
@@ -72,6 +222,8 @@ int main(int argc, const char** argv) {
     header << "namespace Yngine {\n\n";
 
     generate_rays_tables(header);
+    generate_symmetry_tables(header);
+    generate_row_window_tables(header);
 
     header << "}\n\n"; // namespace Yngine
     header << "#endif // YNGINE_TABLES_HPP\n";
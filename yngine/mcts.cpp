@@ -1,47 +1,71 @@
 #include <yngine/mcts.hpp>
+#include <yngine/symmetry.hpp>
 
 #include <limits>
 #include <cmath>
 #include <random>
-#include <iostream>
 #include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 
 namespace Yngine {
 
-MCTSNode::MCTSNode(Move parent_move, MCTSNode* parent, Color color)
+MCTSNode::MCTSNode(Move parent_move, PoolIndex parent, Color color)
     : half_wins_and_simulations{0}
-    , is_parent{false}
-    , is_expandable{false}
-    , unexpanded_child{nullptr}
-    , is_fully_expanded{false}
-    , parent_move{parent_move}
+    , unexpanded_child{POOL_NULL_INDEX}
     , parent{parent}
-    , color{color}
-    , first_child{nullptr}
-    , next_sibling{nullptr} {
+    , first_child{POOL_NULL_INDEX}
+    , next_sibling{POOL_NULL_INDEX}
+    , parent_move{parent_move}
+    , flags{0}
+    , color{color} {
 }
 
-void MCTSNode::create_children(PoolAllocator<MCTSNode>& arena, XoshiroCpp::Xoshiro256StarStar& prng, BoardState board_state) {
-    if (this->is_parent.exchange(true) == false) {
+bool MCTSNode::create_children(PoolAllocator<MCTSNode>::LocalCache& cache, NodeBudget& budget, XoshiroCpp::Xoshiro256StarStar& prng, BoardState board_state, bool compound_moves) {
+    const uint8_t previous_flags = this->set_flags(IS_PARENT);
+
+    if ((previous_flags & IS_EXPANDABLE) == 0 && (previous_flags & IS_PARENT) != 0) {
+        ThreadSearchStats::count(SearchEvent::ParentRaceLost);
+    }
+
+    if ((previous_flags & IS_PARENT) == 0) {
         MoveList move_list;
-        board_state.generate_moves(move_list);
+        if (compound_moves) {
+            board_state.generate_compound_moves(move_list);
+        } else {
+            board_state.generate_moves(move_list);
+        }
+
+        // Placements leading to symmetric positions are searched as one child
+        if (board_state.get_next_action() == NextAction::RingPlacement) {
+            board_state.remove_symmetric_moves(move_list);
+        }
+
+        if (!budget.reserve(move_list.get_size())) {
+            this->clear_flags(IS_PARENT);
+            return false;
+        }
 
         std::shuffle(&move_list[0], &move_list[move_list.get_size()], prng);
 
+        const PoolAllocator<MCTSNode>& pool = cache.get_pool();
         const Color node_color = board_state.whose_move();
+        const PoolIndex this_index = pool.index_of(this);
 
-        const auto new_first_child = arena.allocate(
+        const auto new_first_child = cache.allocate(
             move_list[0],
-            this,
+            this_index,
             node_color
         );
 
         if (!new_first_child) {
-            this->is_parent.store(false);
-            return;
+            budget.release(move_list.get_size());
+            this->clear_flags(IS_PARENT);
+            return false;
         }
 
-        this->first_child = new_first_child;
+        this->first_child = pool.index_of(new_first_child);
 
         bool failed_to_allocate_children = false;
 
@@ -49,9 +73,9 @@ void MCTSNode::create_children(PoolAllocator<MCTSNode>& arena, XoshiroCpp::Xoshi
         for (int move_index = 1; move_index < move_list.get_size(); move_index++) {
             const auto move = move_list[move_index];
 
-            MCTSNode* new_child = arena.allocate(
+            MCTSNode* new_child = cache.allocate(
                 move,
-                this,
+                this_index,
                 node_color
             );
 
@@ -62,54 +86,86 @@ void MCTSNode::create_children(PoolAllocator<MCTSNode>& arena, XoshiroCpp::Xoshi
                 break;
             }
 
-            last_child->next_sibling = new_child;
+            last_child->next_sibling = pool.index_of(new_child);
             last_child = new_child;
         }
 
         // Deallocate children if failed
         if (failed_to_allocate_children) {
-            MCTSNode* current_child = this->first_child;
+            MCTSNode* current_child = pool.get(this->first_child);
             while (current_child) {
-                const auto next_child = current_child->next_sibling;
+                const auto next_child = pool.get(current_child->next_sibling);
 
-                arena.free(current_child);
+                cache.free(current_child);
 
                 current_child = next_child;
             }
 
-            this->first_child = nullptr;
-            this->is_parent.store(false);
+            this->first_child = POOL_NULL_INDEX;
+            budget.release(move_list.get_size());
+            this->clear_flags(IS_PARENT);
 
-            return;
+            return false;
         }
 
         this->unexpanded_child.store(this->first_child);
-        this->is_expandable.store(true, std::memory_order_release);
+        this->set_flags(IS_EXPANDABLE, std::memory_order_release);
     }
+
+    return true;
 }
 
-MCTSNode* MCTSNode::add_child() {
-    if (this->is_expandable.load(std::memory_order_acquire) == true) {
-        MCTSNode* expected = this->unexpanded_child.load();
-        MCTSNode* desired;
+MCTSNode* MCTSNode::add_child(const PoolAllocator<MCTSNode>& pool) {
+    if (this->has_flags(IS_EXPANDABLE, std::memory_order_acquire)) {
+        PoolIndex expected = this->unexpanded_child.load();
+        PoolIndex desired;
 
         do {
-            if (expected == nullptr)
+            if (expected == POOL_NULL_INDEX)
                 return this;
 
-            desired = expected->next_sibling;
+            desired = pool.get(expected)->next_sibling;
         } while (!this->unexpanded_child.compare_exchange_weak(expected, desired));
 
-        if (expected->next_sibling == nullptr) {
-            this->is_fully_expanded.store(true);
+        MCTSNode* expected_node = pool.get(expected);
+
+        if (expected_node->next_sibling == POOL_NULL_INDEX) {
+            this->set_flags(IS_FULLY_EXPANDED);
         }
 
-        return expected;
+        return expected_node;
     } else {
         return this;
     }
 }
 
+bool MCTSNode::has_flags(uint8_t mask, std::memory_order order) const {
+    return (this->flags.load(order) & mask) == mask;
+}
+
+uint8_t MCTSNode::set_flags(uint8_t mask, std::memory_order order) {
+    return this->flags.fetch_or(mask, order);
+}
+
+void MCTSNode::clear_flags(uint8_t mask) {
+    this->flags.fetch_and(static_cast<uint8_t>(~mask));
+}
+
+std::optional<GameResult> MCTSNode::get_proven_result() const {
+    const uint8_t proven = (this->flags.load() & PROVEN_RESULT) >> 3;
+
+    if (proven == 0) {
+        return std::nullopt;
+    }
+
+    return static_cast<GameResult>(proven - 1);
+}
+
+void MCTSNode::set_proven_result(GameResult result) {
+    // Results are proven the same way by every thread, so setting the bits twice is fine
+    this->set_flags(static_cast<uint8_t>((static_cast<uint8_t>(result) + 1) << 3));
+}
+
 void MCTSNode::add_half_wins_and_simulations(uint32_t half_wins, uint32_t simulations) {
     uint64_t increase =
         static_cast<uint64_t>(half_wins) << 32 |
@@ -150,286 +206,1740 @@ float MCTSNode::compute_uct(uint32_t parent_simulations) const {
     return exploitation + exploration;
 }
 
-MCTS::MCTS(std::size_t memory_limit_bytes)
-    : board_state{}
-    , pool{memory_limit_bytes}
-    , root{nullptr}
-    , stop_search{false} {
+SearchHandle::SearchHandle(MCTS& mcts, std::shared_future<Move> result)
+    : mcts{&mcts}
+    , result{std::move(result)} {
 }
 
-MCTS::~MCTS() {
-    this->stop_search = true;
-    this->search_thread.join();
+void SearchHandle::stop() {
+    this->mcts->stop();
 }
 
-std::future<Move> MCTS::search(SearchLimit search_limit, int thread_count) {
-    std::packaged_task<Move(MCTS*, SearchLimit, int)> task{&MCTS::search_threaded};
-    auto future = task.get_future();
+bool SearchHandle::is_done() const {
+    return this->result.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+}
 
-    if (this->search_thread.joinable()) {
-        this->search_thread.join();
+Move SearchHandle::wait() const {
+    return this->result.get();
+}
+
+SearchInfo SearchHandle::get_progress() const {
+    if (this->is_done()) {
+        return this->mcts->get_search_info();
     }
-    this->search_thread = std::thread{std::move(task), this, search_limit, thread_count};
 
-    return std::move(future);
+    return this->mcts->get_search_progress();
 }
 
-Move MCTS::search_threaded(SearchLimit limit, int thread_count) {
-    // Check if we only have one move, if so return it immediatly
-    MoveList moves_from_root;
-    this->board_state.generate_moves(moves_from_root);
-    if (moves_from_root.get_size() == 1) {
-        return moves_from_root[0];
+std::optional<Move> SearchHandle::best_so_far() const {
+    if (this->is_done()) {
+        return this->result.get();
     }
 
-    // Allocate root node if we haven't retained a tree from previous search
-    if (!this->root) {
-        this->root = this->pool.allocate(
-            PassMove{},
-            nullptr,
-            opposite(this->board_state.whose_move()) // Color here doesn't matter
-        );
+    const auto info = this->mcts->get_search_progress();
+    if (info.principal_variation.empty()) {
+        return std::nullopt;
+    }
 
-        if (!this->root) {
-            abort();
-        }
+    return MCTS::to_game_move(info.principal_variation.front());
+}
+
+SearchBudget::SearchBudget()
+    : limits_iterations{false}
+    , remaining_iterations{0}
+    , start_root_simulations{0}
+    , stopped{false} {
+}
+
+void SearchBudget::start(SearchLimit limit, uint32_t root_simulations, std::chrono::steady_clock::time_point start_time) {
+    const auto to_duration = [](float seconds) {
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(seconds));
+    };
+
+    this->start_time = start_time;
+    this->start_root_simulations = root_simulations;
+    this->time_manager.reset();
+
+    if (auto* limit_iters = std::get_if<int>(&limit)) {
+        this->limits_iterations = true;
+        this->remaining_iterations = static_cast<int64_t>(*limit_iters) - root_simulations;
+        this->deadline = std::chrono::steady_clock::time_point::max();
+    } else if (auto* limit_seconds = std::get_if<float>(&limit)) {
+        this->limits_iterations = false;
+        this->deadline = this->start_time + to_duration(*limit_seconds);
+    } else if (std::holds_alternative<InfiniteLimit>(limit)) {
+        this->limits_iterations = false;
+        this->deadline = std::chrono::steady_clock::time_point::max();
+    } else if (auto* time_control = std::get_if<TimeControl>(&limit)) {
+        this->limits_iterations = false;
+        this->time_manager.emplace(*time_control);
+        this->deadline = this->start_time + to_duration(this->time_manager->get_deadline_seconds());
+        this->next_time_check = this->start_time + SearchBudget::TIME_CHECK_INTERVAL;
+    } else {
+        assert(false);
     }
 
-    // Start workers
-    std::vector<std::thread> workers;
-    for (int thread_index = 0; thread_index < thread_count; thread_index++) {
-        workers.push_back(std::thread{&MCTS::search_worker, this, this->root, limit});
+    this->stopped = false;
+}
+
+int SearchBudget::claim(int max_iterations) {
+    if (this->stopped.load(std::memory_order_relaxed)) {
+        return 0;
     }
 
-    // Wait for workers to finish
-    for (auto& worker : workers) {
-        worker.join();
+    if (!this->limits_iterations) {
+        return std::chrono::steady_clock::now() < this->deadline.load(std::memory_order_relaxed) ? max_iterations : 0;
     }
 
-    uint32_t most_simulations = 0;
-    MCTSNode* most_simulations_node = nullptr;
+    const auto remaining = this->remaining_iterations.fetch_sub(max_iterations, std::memory_order_relaxed);
 
-    // @TODO: handle case where no children of the root were created
-    auto child = this->root->first_child;
-    while (true) {
-        const auto simulations = child->get_half_wins_and_simulations().second;
+    return static_cast<int>(std::clamp<int64_t>(remaining, 0, max_iterations));
+}
 
-        if (simulations > most_simulations) {
-            most_simulations = simulations;
-            most_simulations_node = child;
-        }
+void SearchBudget::stop() {
+    this->stopped.store(true, std::memory_order_relaxed);
+}
 
-        if (!child->next_sibling)
-            break;
+bool SearchBudget::is_stopped() const {
+    return this->stopped.load(std::memory_order_relaxed);
+}
+
+float SearchBudget::get_elapsed_seconds() const {
+    return std::chrono::duration<float>(std::chrono::steady_clock::now() - this->start_time).count();
+}
+
+uint32_t SearchBudget::get_start_root_simulations() const {
+    return this->start_root_simulations;
+}
 
-        child = child->next_sibling;
+bool SearchBudget::is_time_check_due() {
+    if (!this->time_manager) {
+        return false;
     }
 
-    const auto best_move = most_simulations_node->parent_move;
+    const auto now = std::chrono::steady_clock::now();
 
-    const auto [half_wins, simulations] = most_simulations_node->get_half_wins_and_simulations();
-    const auto root_simulations = this->root->get_half_wins_and_simulations().second;
+    auto next_check = this->next_time_check.load(std::memory_order_relaxed);
+    if (now < next_check) {
+        return false;
+    }
 
-    std::cout << "DEBUG: win rate = "
-        << ((float)half_wins / 2 / simulations)
-        << ", move confidence = " << ((float)simulations / root_simulations) << std::endl;
+    return this->next_time_check.compare_exchange_strong(next_check, now + SearchBudget::TIME_CHECK_INTERVAL);
+}
 
-    std::cout << "DEBUG: iters = " << root_simulations << ", memory used (MB) = " << (this->pool.used_bytes() / 1024 / 1024) << ", tree size = " << MCTS::tree_size(this->root) << "\n" << std::endl;
+void SearchBudget::check_time(uint32_t root_simulations, uint32_t best_simulations, uint32_t second_simulations) {
+    const auto elapsed = std::chrono::steady_clock::now() - this->start_time;
+
+    const float deadline_seconds = this->time_manager->update(
+        std::chrono::duration<float>(elapsed).count(),
+        root_simulations - this->start_root_simulations,
+        root_simulations,
+        best_simulations,
+        second_simulations
+    );
+
+    this->deadline.store(
+        this->start_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(deadline_seconds)),
+        std::memory_order_relaxed
+    );
+}
 
-    return best_move;
+NodeBudget::NodeBudget(std::size_t limit)
+    : count{0}
+    , limit{limit} {
 }
 
-void MCTS::search_worker(MCTSNode* root, SearchLimit limit) {
-    const auto start_time = std::chrono::steady_clock::now();
+bool NodeBudget::reserve(std::size_t count) {
+    const auto previous_count = this->count.fetch_add(count);
 
-    std::random_device rd;
-    XoshiroCpp::Xoshiro256StarStar prng((static_cast<uint64_t>(rd()) << 32) | rd());
+    if (previous_count + count > this->limit) {
+        this->count.fetch_sub(count);
+        return false;
+    }
 
-    while (!this->stop_search) {
-        // Check if we exceeded the computational budget
-        if (auto* limit_iters = std::get_if<int>(&limit)) {
-            if (root->get_half_wins_and_simulations().second >= *limit_iters) {
-                break;
-            }
-        } else if (auto* limit_seconds = std::get_if<float>(&limit)) {
-            const auto elapsed = std::chrono::steady_clock::now() - start_time;
-            const auto elapsed_seconds = std::chrono::duration<float>(elapsed).count();
+    return true;
+}
 
-            if (elapsed_seconds >= *limit_seconds) {
-                break;
-            }
-        } else {
-            assert(false);
-        }
+void NodeBudget::release(std::size_t count) {
+    this->count.fetch_sub(count);
+}
 
-        // Selection phase
-        auto [selected_node, selected_board_state] = MCTS::select(root, this->board_state);
+std::size_t NodeBudget::get_count() const {
+    return this->count;
+}
 
-        // Expansion phase
-        MCTSNode* expanded_node = MCTS::expand(selected_node, selected_board_state, pool, prng);
+std::size_t NodeBudget::get_limit() const {
+    return this->limit;
+}
 
-        // Simulation phase
-        GameResult playout_result = MCTS::playout(expanded_node, selected_board_state, prng);
+TreeReclaimer::TreeReclaimer(PoolAllocator<MCTSNode>& pool)
+    : pool{pool}
+    , pending{false}
+    , stop{false} {
+    this->thread = std::thread{&TreeReclaimer::worker, this};
+}
 
-        // Backpropagation phase
-        MCTS::backup(expanded_node, playout_result);
+TreeReclaimer::~TreeReclaimer() {
+    {
+        std::unique_lock lock{this->mutex};
+        this->stop = true;
     }
+
+    this->condition.notify_one();
+    this->thread.join();
 }
 
-std::tuple<MCTSNode*, BoardState> MCTS::select(MCTSNode* root, BoardState root_board_state) {
-    MCTSNode* current = root;
-    BoardState current_board_state = root_board_state;
+void TreeReclaimer::release(MCTSNode* subtree, NodeBudget& budget, TraceRecorder* trace_recorder) {
+    {
+        std::unique_lock lock{this->mutex};
+        this->queue.push_back(Release{
+            .subtree = this->pool.index_of(subtree),
+            .budget = &budget,
+            .trace_recorder = trace_recorder,
+        });
+        this->pending = true;
+    }
 
-    while (current->is_fully_expanded.load()) {
-        uint32_t parent_simulations = current->get_half_wins_and_simulations().second;
+    this->condition.notify_one();
+}
+
+bool TreeReclaimer::is_pending() const {
+    return this->pending.load(std::memory_order_relaxed);
+}
 
-        MCTSNode* greatest_uct_node = current->first_child;
-        float greatest_uct = greatest_uct_node->compute_uct(parent_simulations);
+void TreeReclaimer::wait_until_idle() {
+    std::unique_lock lock{this->mutex};
 
-        MCTSNode* current_child = current->first_child;
-        while (current_child->next_sibling) {
-            if (std::isinf(greatest_uct))
-                break;
+    this->idle_condition.wait(lock, [this] {
+        return !this->pending;
+    });
+}
+
+std::size_t TreeReclaimer::free_subtree(MCTSNode* node, PoolAllocator<MCTSNode>::LocalCache& cache) {
+    const PoolAllocator<MCTSNode>& pool = cache.get_pool();
 
-            current_child = current_child->next_sibling;
+    // Nodes that are left to free are chained through their next_sibling links,
+    // so deep trees are freed without recursion or any extra memory
+    node->next_sibling = POOL_NULL_INDEX;
 
-            const auto current_uct = current_child->compute_uct(parent_simulations);
-            if (current_uct > greatest_uct) {
-                greatest_uct = current_uct;
-                greatest_uct_node = current_child;
+    std::size_t freed = 0;
+
+    MCTSNode* current = node;
+    while (current) {
+        MCTSNode* next = pool.get(current->next_sibling);
+
+        MCTSNode* first_child = pool.get(current->first_child);
+        if (first_child) {
+            MCTSNode* last_child = first_child;
+            while (last_child->next_sibling) {
+                last_child = pool.get(last_child->next_sibling);
             }
+
+            last_child->next_sibling = pool.index_of(next);
+            next = first_child;
         }
 
-        current = greatest_uct_node;
-        current_board_state.apply_move(greatest_uct_node->parent_move);
+        cache.free(current);
+        freed++;
+
+        current = next;
     }
 
-    return std::tie(current, current_board_state);
+    return freed;
 }
 
-MCTSNode* MCTS::expand(MCTSNode* node, BoardState board_state, PoolAllocator<MCTSNode>& pool, XoshiroCpp::Xoshiro256StarStar& prng) {
-    MCTSNode* result = node;
+void TreeReclaimer::worker() {
+    PoolAllocator<MCTSNode>::LocalCache cache{this->pool};
 
-    if (board_state.get_next_action() != NextAction::Done) {
-        node->create_children(pool, prng, board_state);
-        result = node->add_child();
+    std::unique_lock lock{this->mutex};
+
+    while (true) {
+        this->condition.wait(lock, [this] {
+            return this->stop || !this->queue.empty();
+        });
+
+        if (this->stop) {
+            return;
+        }
+
+        const auto [subtree, budget, trace_recorder] = this->queue.back();
+        this->queue.pop_back();
+
+        lock.unlock();
+        const uint64_t trace_start = trace_recorder ? trace_recorder->now() : 0;
+
+        const auto freed = TreeReclaimer::free_subtree(this->pool.get(subtree), cache);
+
+        if (trace_recorder) {
+            trace_recorder->complete("free subtree", trace_start, freed);
+        }
+
+        budget->release(freed);
+        lock.lock();
+
+        if (this->queue.empty()) {
+            cache.flush();
+            this->pending = false;
+            this->idle_condition.notify_all();
+        }
     }
+}
 
-    return result;
+MCTS::MCTS(std::size_t memory_limit_bytes, ArenaOptions arena_options)
+    : board_state{}
+    , root_board_state{}
+    , tree_symmetry{SYMMETRY_IDENTITY}
+    , compound_moves{false}
+    , opening_book{nullptr}
+    , trace_recorder{nullptr}
+    , trace_search_start{0}
+    , expansion_failure_traced{false}
+    , owned_pool{std::make_unique<PoolAllocator<MCTSNode>>(memory_limit_bytes, arena_options)}
+    , owned_reclaimer{std::make_unique<TreeReclaimer>(*this->owned_pool)}
+    , pool{*this->owned_pool}
+    , reclaimer{*this->owned_reclaimer}
+    , node_budget{memory_limit_bytes / PoolAllocator<MCTSNode>::node_bytes()}
+    , root{nullptr}
+    , progress_interval{0}
+    , prune_requested{false}
+    , can_prune{true}
+    , active_workers{0}
+    , reclaimed_nodes{0} {
 }
 
-GameResult MCTS::playout(MCTSNode* node, BoardState board_state, XoshiroCpp::Xoshiro256StarStar& prng) {
-    board_state.playout(prng);
-    return board_state.game_result();
+MCTS::MCTS(PoolAllocator<MCTSNode>& shared_pool, TreeReclaimer& shared_reclaimer, std::size_t memory_quota_bytes)
+    : board_state{}
+    , root_board_state{}
+    , tree_symmetry{SYMMETRY_IDENTITY}
+    , compound_moves{false}
+    , opening_book{nullptr}
+    , trace_recorder{nullptr}
+    , trace_search_start{0}
+    , expansion_failure_traced{false}
+    , pool{shared_pool}
+    , reclaimer{shared_reclaimer}
+    , node_budget{memory_quota_bytes / PoolAllocator<MCTSNode>::node_bytes()}
+    , root{nullptr}
+    , progress_interval{0}
+    , prune_requested{false}
+    , can_prune{true}
+    , active_workers{0}
+    , reclaimed_nodes{0} {
 }
 
-void MCTS::backup(MCTSNode* from, GameResult playout_result) {
-    MCTSNode* propagation_current = from;
-    while (propagation_current->parent) {
-        uint32_t half_wins = 0;
+MCTS::~MCTS() {
+    this->search_budget.stop();
+    if (this->search_thread.joinable()) {
+        this->search_thread.join();
+    }
 
-        if (playout_result == GameResult::Draw) {
-            half_wins = 1;
-        } else {
-            const auto node_color = propagation_current->color;
+    // Trees sharing the pool have to give their nodes back
+    if (!this->owned_pool && this->root) {
+        this->reclaimer.release(this->root, this->node_budget);
+    }
 
-            if (playout_result == GameResult::WhiteWon && node_color == Color::White ||
-                playout_result == GameResult::BlackWon && node_color == Color::Black) {
-                half_wins = 2;
-            }
-        }
+    // The reclaimer might still be freeing our subtrees and releasing them from our budget
+    this->reclaimer.wait_until_idle();
+}
 
-        propagation_current->add_half_wins_and_simulations(half_wins, 1);
+std::future<Move> MCTS::search(SearchLimit search_limit, int thread_count) {
+    return this->launch_search(search_limit, thread_count, {}, std::chrono::milliseconds{0});
+}
+
+SearchHandle MCTS::start_search(
+    SearchLimit search_limit,
+    int thread_count,
+    std::function<void(const SearchInfo&)> progress_callback,
+    std::chrono::milliseconds progress_interval
+) {
+    return SearchHandle{
+        *this,
+        this->launch_search(search_limit, thread_count, std::move(progress_callback), progress_interval).share()
+    };
+}
+
+void MCTS::stop() {
+    this->search_budget.stop();
 
-        propagation_current = propagation_current->parent;
+    if (this->trace_recorder) {
+        this->trace_recorder->instant("search stop");
     }
+}
 
-    // Add 1 simulation to the root, we don't track wins for it
-    propagation_current->add_half_wins_and_simulations(0, 1);
+SearchInfo MCTS::get_search_progress() {
+    if (!this->root) {
+        return SearchInfo{};
+    }
+
+    // Keeps the tree from being pruned while we read it
+    this->enter_search();
+    const auto info = this->collect_search_info();
+    this->leave_search();
+
+    return info;
 }
 
-void MCTS::free_subtree(MCTSNode* node) {
-    // @TODO: do we want to reverse the freeing order?
-    MCTSNode* current_child = node->first_child;
-    while (current_child) {
-        MCTSNode* next_child = current_child->next_sibling;
+std::future<Move> MCTS::launch_search(
+    SearchLimit search_limit,
+    int thread_count,
+    std::function<void(const SearchInfo&)> progress_callback,
+    std::chrono::milliseconds progress_interval
+) {
+    if (this->search_thread.joinable()) {
+        this->search_thread.join();
+    }
+
+    // The search is started before we return, so stopping it right away isn't lost
+    if (const auto move = this->begin_search(search_limit)) {
+        std::promise<Move> promise;
+        promise.set_value(*move);
+        return promise.get_future();
+    }
 
-        this->free_subtree(current_child);
+    this->progress_callback = std::move(progress_callback);
+    this->progress_interval = progress_interval;
+    this->next_progress_report = std::chrono::steady_clock::now() + progress_interval;
 
-        current_child = next_child;
+    std::packaged_task<Move(MCTS*, int)> task{&MCTS::search_threaded};
+    auto future = task.get_future();
+
+    this->search_thread = std::thread{std::move(task), this, thread_count};
+
+    return future;
+}
+
+Move MCTS::search_threaded(int thread_count) {
+    // Start workers
+    std::vector<std::thread> workers;
+    for (int thread_index = 0; thread_index < thread_count; thread_index++) {
+        workers.push_back(std::thread{&MCTS::search_worker, this});
+    }
+
+    // Wait for workers to finish
+    for (auto& worker : workers) {
+        worker.join();
     }
 
-    this->pool.free(node);
+    return this->finish_search();
 }
 
-void MCTS::apply_move(Move move) {
-    this->board_state.apply_move(move);
+std::optional<Move> MCTS::begin_search(SearchLimit limit) {
+    const auto start_time = std::chrono::steady_clock::now();
 
-    // Reuse part of the tree that we have from previous searches if possible
-    if (this->root) {
-        MCTSNode* new_root = nullptr;
-        MCTSNode* current_child = this->root->first_child;
+    // Moves answered without a search don't keep the statistics of the previous one
+    this->search_info = SearchInfo{};
 
-        if (!current_child) {
-            this->root = nullptr;
-            return;
+    // Check if we only have one move, if so return it immediatly
+    MoveList moves_from_root;
+    this->board_state.generate_moves(moves_from_root);
+    if (moves_from_root.get_size() == 1) {
+        return moves_from_root[0];
+    }
+
+    // Different positions can share a key, so the move of the book has to be legal
+    if (this->opening_book) {
+        if (const auto book_move = this->opening_book->lookup(this->board_state)) {
+            for (std::size_t move_index = 0; move_index < moves_from_root.get_size(); move_index++) {
+                if (moves_from_root[move_index] == *book_move) {
+                    return *book_move;
+                }
+            }
         }
+    }
 
-        while (current_child) {
-            MCTSNode* next_child = current_child->next_sibling;
+    // A lost position is left to the search, which can still hope for a mistake of the opponent
+    if (this->endgame_solver && this->endgame_solver->is_endgame(this->board_state)) {
+        const auto to_duration = [](float seconds) {
+            return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(seconds));
+        };
+
+        // The solve counts against the time of the search. It gets at most half of it, so a
+        //   failed solve leaves the tree enough time to find a move
+        auto deadline = std::chrono::steady_clock::time_point::max();
+        if (const auto* limit_seconds = std::get_if<float>(&limit)) {
+            deadline = start_time + to_duration(0.5f * *limit_seconds);
+        } else if (const auto* time_control = std::get_if<TimeControl>(&limit)) {
+            deadline = start_time + to_duration(0.5f * TimeManager{*time_control}.get_deadline_seconds());
+        }
 
-            if (current_child->parent_move == move) {
-                assert(new_root == nullptr);
-                new_root = current_child;
-            } else {
-                this->free_subtree(current_child);
-            }
+        const auto solved = this->endgame_solver->solve(this->board_state, deadline);
+
+        const auto lost = this->board_state.whose_move() == Color::White
+            ? GameResult::BlackWon : GameResult::WhiteWon;
+
+        if (solved.result && *solved.result != lost) {
+            return *solved.best_move;
+        }
+    }
 
-            current_child = next_child;
+    // The tree already chose the ring to remove together with the removed row
+    if (this->root && this->pending_row_removal) {
+        if (const auto ring_removal = this->pending_ring_removal()) {
+            return *ring_removal;
         }
+    }
 
-        if (new_root) {
-            new_root->next_sibling = nullptr;
-            new_root->parent = nullptr;
+    // The game went to a position the tree doesn't have
+    if (this->root && this->board_state.transformed(this->tree_symmetry) != this->root_board_state) {
+        this->reroot(nullptr);
+    }
 
-            this->root = new_root;
-        } else {
-            this->root = nullptr;
+    // Allocate root node if we haven't retained a tree from previous search
+    if (!this->root) {
+        this->root_board_state = this->board_state;
+        this->tree_symmetry = SYMMETRY_IDENTITY;
+        this->pending_row_removal.reset();
+
+        if (!this->node_budget.reserve(1)) {
+            abort();
+        }
+
+        this->root = this->pool.allocate(
+            PassMove{},
+            POOL_NULL_INDEX,
+            opposite(this->board_state.whose_move()) // Color here doesn't matter
+        );
+
+        if (!this->root) {
+            abort();
         }
     }
 
-    if (this->root) {
-        auto [half_wins, simulations] = this->root->get_half_wins_and_simulations();
-        std::cout << "DEBUG: move winrate = " << (float)half_wins / 2 / simulations << "\n";
+    // If the result was proven by previous searches we already know the best move,
+    //   a proven root without children is searched like any other
+    if (this->root->get_proven_result()) {
+        if (const MCTSNode* proven_child = MCTS::best_child(this->root, this->pool)) {
+            return this->to_game_frame(MCTS::to_game_move(proven_child->parent_move));
+        }
     }
 
-    std::cout << "DEBUG: tree size after move = " << MCTS::tree_size(this->root) << "\n" << std::endl;
-}
+    this->search_budget.start(limit, this->root->get_half_wins_and_simulations().second, start_time);
+    this->can_prune = true;
 
-void MCTS::set_board(BoardState board) {
-    this->board_state = board;
-}
+    if (this->trace_recorder) {
+        this->trace_search_start = this->trace_recorder->now();
+        this->trace_recorder->instant("search start");
+        this->expansion_failure_traced.store(false, std::memory_order_relaxed);
+    }
 
-BoardState MCTS::get_board() const {
-    return this->board_state;
+    if constexpr (SEARCH_STATS_ENABLED) {
+        std::unique_lock lock{this->search_stats_mutex};
+        this->search_stats = SearchStats{};
+    }
+
+    return std::nullopt;
 }
 
-MCTSNode* MCTS::get_root() const {
-    return this->root;
+int MCTS::search_slice(int max_iterations, PoolAllocator<MCTSNode>::LocalCache& cache, XoshiroCpp::Xoshiro256StarStar& prng) {
+    this->enter_search();
+
+    int iterations = 0;
+    while (iterations < max_iterations) {
+        const int chunk = this->search_budget.claim(std::min(max_iterations - iterations, SearchBudget::CHUNK_ITERATIONS));
+        if (chunk == 0) {
+            break;
+        }
+
+        if (this->search_budget.is_time_check_due()) {
+            this->check_time();
+        }
+
+        if (this->progress_callback && this->is_progress_report_due()) {
+            this->progress_callback(this->collect_search_info());
+        }
+
+        const uint64_t trace_start = this->trace_recorder ? this->trace_recorder->now() : 0;
+        const int chunk_start_iterations = iterations;
+
+        for (int chunk_iteration = 0; chunk_iteration < chunk; chunk_iteration++) {
+            if (this->prune_requested.load(std::memory_order_relaxed)) {
+                this->wait_for_pruning();
+            }
+
+            // The root was proven or the search was cancelled
+            if (this->search_budget.is_stopped()) {
+                break;
+            }
+
+            this->run_iteration(cache, prng);
+            iterations++;
+        }
+
+        if (this->trace_recorder) {
+            this->trace_recorder->complete("iterations", trace_start, iterations - chunk_start_iterations);
+        }
+    }
+
+    if constexpr (SEARCH_STATS_ENABLED) {
+        const auto thread_stats = ThreadSearchStats::take();
+
+        std::unique_lock lock{this->search_stats_mutex};
+        this->search_stats.merge(thread_stats);
+    }
+
+    this->leave_search();
+
+    return iterations;
+}
+
+bool MCTS::is_progress_report_due() {
+    const auto now = std::chrono::steady_clock::now();
+
+    auto next_report = this->next_progress_report.load(std::memory_order_relaxed);
+    if (now < next_report) {
+        return false;
+    }
+
+    return this->next_progress_report.compare_exchange_strong(next_report, now + this->progress_interval);
+}
+
+void MCTS::check_time() {
+    uint32_t best_simulations = 0;
+    uint32_t second_simulations = 0;
+
+    MCTSNode* current_child = this->pool.get(this->root->first_child);
+    while (current_child) {
+        const auto simulations = current_child->get_half_wins_and_simulations().second;
+
+        if (simulations > best_simulations) {
+            second_simulations = best_simulations;
+            best_simulations = simulations;
+        } else if (simulations > second_simulations) {
+            second_simulations = simulations;
+        }
+
+        current_child = this->pool.get(current_child->next_sibling);
+    }
+
+    this->search_budget.check_time(
+        this->root->get_half_wins_and_simulations().second,
+        best_simulations,
+        second_simulations
+    );
+}
+
+Move MCTS::finish_search() {
+    // @TODO: handle case where no children of the root were created
+    const auto best_move = this->to_game_frame(MCTS::to_game_move(MCTS::best_child(this->root, this->pool)->parent_move));
+
+    this->search_info = this->collect_search_info();
+
+    if (this->trace_recorder) {
+        this->trace_recorder->complete("search", this->trace_search_start, this->search_info.iterations);
+    }
+
+    if (this->search_info_callback) {
+        this->search_info_callback(this->search_info);
+    }
+
+    return best_move;
+}
+
+SearchInfo MCTS::collect_search_info() const {
+    const auto root_simulations = this->root->get_half_wins_and_simulations().second;
+
+    SearchInfo info{};
+    info.is_searched = true;
+    info.iterations = root_simulations - this->search_budget.get_start_root_simulations();
+    info.root_simulations = root_simulations;
+    info.elapsed_seconds = this->search_budget.get_elapsed_seconds();
+    info.iterations_per_second = info.elapsed_seconds > 0.0f ? info.iterations / info.elapsed_seconds : 0.0f;
+
+    info.tree_nodes = this->node_budget.get_count();
+    info.reclaimed_nodes = this->reclaimed_nodes;
+    info.pool_used_bytes = this->pool.used_bytes();
+    info.pool_capacity_bytes = this->pool.capacity_bytes();
+    info.board_cache_bytes = this->board_cache ? this->board_cache->memory_bytes() : 0;
+
+    if constexpr (SEARCH_STATS_ENABLED) {
+        std::unique_lock lock{this->search_stats_mutex};
+        info.search_stats = this->search_stats;
+    }
+
+    info.proven_result = this->root->get_proven_result();
+
+    MCTSNode* current_child = this->pool.get(this->root->first_child);
+    while (current_child) {
+        const auto [half_wins, simulations] = current_child->get_half_wins_and_simulations();
+
+        info.root_children.push_back(RootChildInfo{
+            .move = this->to_game_frame(current_child->parent_move),
+            .simulations = simulations,
+            .win_rate = simulations > 0 ? (float)half_wins / 2 / simulations : 0.0f,
+            .proven_result = current_child->get_proven_result(),
+        });
+
+        current_child = this->pool.get(current_child->next_sibling);
+    }
+
+    // Follow the best moves down the tree for as long as they were searched
+    MCTSNode* current_node = MCTS::best_child(this->root, this->pool);
+    if (current_node) {
+        const auto [half_wins, simulations] = current_node->get_half_wins_and_simulations();
+        info.win_rate = simulations > 0 ? (float)half_wins / 2 / simulations : 0.0f;
+    }
+
+    while (current_node
+        && current_node->get_half_wins_and_simulations().second > 0
+        && info.principal_variation.size() < MCTS::MAX_PRINCIPAL_VARIATION_LENGTH) {
+        info.principal_variation.push_back(this->to_game_frame(current_node->parent_move));
+        current_node = MCTS::best_child(current_node, this->pool);
+    }
+
+    return info;
+}
+
+SearchInfo MCTS::get_search_info() const {
+    return this->search_info;
+}
+
+void MCTS::set_search_info_callback(std::function<void(const SearchInfo&)> callback) {
+    this->search_info_callback = std::move(callback);
+}
+
+std::size_t MCTS::get_node_count() const {
+    return this->node_budget.get_count();
+}
+
+void MCTS::search_worker() {
+    std::random_device rd;
+    XoshiroCpp::Xoshiro256StarStar prng((static_cast<uint64_t>(rd()) << 32) | rd());
+
+    PoolAllocator<MCTSNode>::LocalCache cache{this->pool};
+
+    this->search_slice(std::numeric_limits<int>::max(), cache, prng);
+}
+
+void MCTS::run_iteration(PoolAllocator<MCTSNode>::LocalCache& cache, XoshiroCpp::Xoshiro256StarStar& prng) {
+    uint64_t phase_start = ThreadSearchStats::begin_phase();
+
+    // Selection phase
+    auto [selected_node, selected_board_state] = MCTS::select(this->root, this->root_board_state, this->pool, this->board_cache.get(), this->compound_moves);
+    phase_start = ThreadSearchStats::end_phase(SearchPhase::Select, phase_start);
+
+    // Expansion phase
+    bool out_of_memory = false;
+    MCTSNode* expanded_node = MCTS::expand(selected_node, selected_board_state, cache, this->node_budget, prng, this->compound_moves, out_of_memory);
+    phase_start = ThreadSearchStats::end_phase(SearchPhase::Expand, phase_start);
+
+    // The tree can't grow anymore, ask the workers to stop so we can reclaim some nodes,
+    // unless the subtrees released by the last move are still being freed
+    if (out_of_memory && this->can_prune && !this->reclaimer.is_pending()) {
+        this->prune_requested.store(true);
+
+        if (this->trace_recorder) {
+            this->trace_recorder->instant("pool exhausted", this->node_budget.get_count());
+        }
+    }
+
+    if (out_of_memory && this->trace_recorder && !this->expansion_failure_traced.exchange(true, std::memory_order_relaxed)) {
+        this->trace_recorder->instant("expansion failed", this->node_budget.get_count());
+    }
+
+    // Terminal positions have an exact result which we propagate up the tree
+    if (selected_board_state.get_next_action() == NextAction::Done) {
+        const auto game_result = selected_board_state.game_result();
+
+        expanded_node->set_proven_result(game_result);
+
+        MCTS::backup(expanded_node, game_result, this->pool);
+        MCTS::backup_proof(expanded_node, this->pool);
+        ThreadSearchStats::end_phase(SearchPhase::Backup, phase_start);
+
+        // Nothing left to search if the result of the game is known
+        if (this->root->get_proven_result()) {
+            this->search_budget.stop();
+        }
+
+        return;
+    }
+
+    // Simulation phase
+    GameResult playout_result = MCTS::playout(expanded_node, selected_board_state, prng);
+    phase_start = ThreadSearchStats::end_phase(SearchPhase::Playout, phase_start);
+
+    // Backpropagation phase
+    MCTS::backup(expanded_node, playout_result, this->pool);
+    ThreadSearchStats::end_phase(SearchPhase::Backup, phase_start);
+}
+
+std::tuple<MCTSNode*, BoardState> MCTS::select(MCTSNode* root, const BoardState& root_board_state, const PoolAllocator<MCTSNode>& pool, BoardCache* board_cache, bool compound_moves) {
+    MCTSNode* current = root;
+    BoardState current_board_state = root_board_state;
+
+    // Moves down to the cached depth are applied only once we get below it,
+    // starting from the deepest node that has its board state cached
+    MCTSNode* cached_path[BoardCache::MAX_DEPTH + 1];
+    const int cached_depth = board_cache ? board_cache->get_max_depth() : 0;
+    int depth = 0;
+
+    while (current->has_flags(MCTSNode::IS_FULLY_EXPANDED)) {
+        uint32_t parent_simulations = current->get_half_wins_and_simulations().second;
+
+        MCTSNode* greatest_uct_node = nullptr;
+        float greatest_uct = -std::numeric_limits<float>::infinity();
+
+        // Subtrees with a proven result don't need any more simulations
+        MCTSNode* current_child = pool.get(current->first_child);
+        while (current_child) {
+            if (!current_child->get_proven_result()) {
+                const auto current_uct = current_child->compute_uct(parent_simulations);
+                if (current_uct > greatest_uct) {
+                    greatest_uct = current_uct;
+                    greatest_uct_node = current_child;
+                }
+
+                if (greatest_uct == std::numeric_limits<float>::infinity())
+                    break;
+            }
+
+            current_child = pool.get(current_child->next_sibling);
+        }
+
+        // All children are proven, the node itself is going to be proven by the thread
+        // which proved its last child, so we just simulate from here meanwhile
+        if (!greatest_uct_node) {
+            break;
+        }
+
+        current = greatest_uct_node;
+        depth++;
+
+        if (depth <= cached_depth) {
+            cached_path[depth] = current;
+            continue;
+        }
+
+        if (depth == cached_depth + 1 && cached_depth > 0) {
+            MCTS::restore_board_state(cached_path, cached_depth, current_board_state, pool, *board_cache, compound_moves);
+        }
+
+        MCTS::apply_tree_move(current_board_state, greatest_uct_node->parent_move, compound_moves);
+    }
+
+    // Selection stopped inside of the cached depth
+    if (depth > 0 && depth <= cached_depth) {
+        MCTS::restore_board_state(cached_path, depth, current_board_state, pool, *board_cache, compound_moves);
+    }
+
+    return std::tie(current, current_board_state);
+}
+
+void MCTS::restore_board_state(MCTSNode* const* path, int depth, BoardState& board_state, const PoolAllocator<MCTSNode>& pool, BoardCache& board_cache, bool compound_moves) {
+    int cached_depth = depth;
+    while (cached_depth > 0 && !board_cache.load(pool.index_of(path[cached_depth]), board_state)) {
+        cached_depth--;
+    }
+
+    for (int path_depth = cached_depth + 1; path_depth <= depth; path_depth++) {
+        MCTSNode* node = path[path_depth];
+        MCTS::apply_tree_move(board_state, node->parent_move, compound_moves);
+
+        if (node->get_half_wins_and_simulations().second >= board_cache.get_min_simulations()) {
+            board_cache.store(pool.index_of(node), board_state);
+        }
+    }
+}
+
+MCTSNode* MCTS::expand(MCTSNode* node, BoardState& board_state, PoolAllocator<MCTSNode>::LocalCache& cache, NodeBudget& budget, XoshiroCpp::Xoshiro256StarStar& prng, bool compound_moves, bool& out_of_memory) {
+    MCTSNode* result = node;
+
+    if (board_state.get_next_action() != NextAction::Done) {
+        out_of_memory = !node->create_children(cache, budget, prng, board_state, compound_moves);
+        result = node->add_child(cache.get_pool());
+
+        if (out_of_memory) {
+            ThreadSearchStats::count(SearchEvent::AllocationFailed);
+        }
+
+        if (result != node) {
+            MCTS::apply_tree_move(board_state, result->parent_move, compound_moves);
+        } else if (SEARCH_STATS_ENABLED && node->has_flags(MCTSNode::IS_EXPANDABLE)) {
+            ThreadSearchStats::count(SearchEvent::ChildRaceLost);
+        }
+    }
+
+    return result;
+}
+
+GameResult MCTS::playout(MCTSNode* node, BoardState board_state, XoshiroCpp::Xoshiro256StarStar& prng) {
+    board_state.playout(prng);
+    return board_state.game_result();
+}
+
+void MCTS::backup(MCTSNode* from, GameResult playout_result, const PoolAllocator<MCTSNode>& pool) {
+    MCTSNode* propagation_current = from;
+    while (propagation_current->parent) {
+        uint32_t half_wins = 0;
+
+        if (playout_result == GameResult::Draw) {
+            half_wins = 1;
+        } else {
+            const auto node_color = propagation_current->color;
+
+            if (playout_result == GameResult::WhiteWon && node_color == Color::White ||
+                playout_result == GameResult::BlackWon && node_color == Color::Black) {
+                half_wins = 2;
+            }
+        }
+
+        propagation_current->add_half_wins_and_simulations(half_wins, 1);
+
+        propagation_current = pool.get(propagation_current->parent);
+    }
+
+    // Add 1 simulation to the root, we don't track wins for it
+    propagation_current->add_half_wins_and_simulations(0, 1);
+}
+
+bool MCTS::prove_from_children(MCTSNode* node, const PoolAllocator<MCTSNode>& pool) {
+    // Children are only linked in all at once, before the node becomes expandable
+    if (!node->has_flags(MCTSNode::IS_EXPANDABLE, std::memory_order_acquire)) {
+        return false;
+    }
+
+    MCTSNode* current_child = pool.get(node->first_child);
+
+    // All children were moved into by the same player
+    const Color mover = current_child->color;
+    const GameResult mover_won = mover == Color::White ? GameResult::WhiteWon : GameResult::BlackWon;
+    const GameResult mover_lost = mover == Color::White ? GameResult::BlackWon : GameResult::WhiteWon;
+
+    bool all_children_proven = true;
+    bool has_draw = false;
+
+    while (current_child) {
+        const auto child_result = current_child->get_proven_result();
+
+        // The mover picks the winning move, so one is enough
+        if (child_result == mover_won) {
+            node->set_proven_result(mover_won);
+            return true;
+        }
+
+        if (!child_result) {
+            all_children_proven = false;
+        } else if (child_result == GameResult::Draw) {
+            has_draw = true;
+        }
+
+        current_child = pool.get(current_child->next_sibling);
+    }
+
+    if (!all_children_proven) {
+        return false;
+    }
+
+    node->set_proven_result(has_draw ? GameResult::Draw : mover_lost);
+
+    return true;
+}
+
+void MCTS::backup_proof(MCTSNode* from, const PoolAllocator<MCTSNode>& pool) {
+    MCTSNode* current = pool.get(from->parent);
+
+    while (current && MCTS::prove_from_children(current, pool)) {
+        current = pool.get(current->parent);
+    }
+}
+
+MCTSNode* MCTS::best_child(MCTSNode* node, const PoolAllocator<MCTSNode>& pool) {
+    MCTSNode* first_child = pool.get(node->first_child);
+    if (!first_child) {
+        return nullptr;
+    }
+
+    const Color mover = first_child->color;
+    const GameResult mover_won = mover == Color::White ? GameResult::WhiteWon : GameResult::BlackWon;
+    const GameResult mover_lost = mover == Color::White ? GameResult::BlackWon : GameResult::WhiteWon;
+
+    // A proven win is always the best move, and a proven loss is only picked if
+    // there is nothing else, otherwise the most simulated child is the best
+    MCTSNode* most_simulations_node = nullptr;
+    uint32_t most_simulations = 0;
+    bool most_simulations_is_lost = true;
+
+    MCTSNode* current_child = first_child;
+    while (current_child) {
+        const auto child_result = current_child->get_proven_result();
+
+        if (child_result == mover_won) {
+            return current_child;
+        }
+
+        const bool is_lost = child_result == mover_lost;
+        const auto simulations = current_child->get_half_wins_and_simulations().second;
+
+        if (!most_simulations_node ||
+            (most_simulations_is_lost && !is_lost) ||
+            (most_simulations_is_lost == is_lost && simulations > most_simulations)) {
+            most_simulations_node = current_child;
+            most_simulations = simulations;
+            most_simulations_is_lost = is_lost;
+        }
+
+        current_child = pool.get(current_child->next_sibling);
+    }
+
+    return most_simulations_node;
+}
+
+void MCTS::enter_search() {
+    std::unique_lock lock{this->prune_mutex};
+
+    // Don't touch the tree while it's being pruned
+    this->prune_condition.wait(lock, [this] {
+        return !this->prune_requested;
+    });
+
+    this->active_workers++;
+}
+
+void MCTS::wait_for_pruning() {
+    std::unique_lock lock{this->prune_mutex};
+
+    this->active_workers--;
+
+    if (this->active_workers == 0) {
+        if (this->prune_requested) {
+            const auto reclaimed = this->prune_tree();
+            this->reclaimed_nodes += reclaimed;
+
+            // Nothing left to prune, don't stop the workers again during this search
+            if (reclaimed == 0) {
+                this->can_prune = false;
+            }
+
+            this->prune_requested = false;
+        }
+
+        this->prune_condition.notify_all();
+    } else {
+        this->prune_condition.wait(lock, [this] {
+            return !this->prune_requested;
+        });
+    }
+
+    this->active_workers++;
+}
+
+void MCTS::leave_search() {
+    std::unique_lock lock{this->prune_mutex};
+
+    this->active_workers--;
+
+    // Other workers might be waiting for us to finish the pruning
+    if (this->active_workers == 0 && this->prune_requested) {
+        this->reclaimed_nodes += this->prune_tree();
+        this->prune_requested = false;
+        this->prune_condition.notify_all();
+    }
+}
+
+std::size_t MCTS::prune_tree() {
+    // Must only be called when no workers are touching the tree
+    if (!this->root) {
+        return 0;
+    }
+
+    // Indices of the collapsed nodes are going to be reused
+    if (this->board_cache) {
+        this->board_cache->invalidate();
+    }
+
+    // Nodes on the principal variation are never collapsed
+    std::vector<MCTSNode*> principal_variation;
+    MCTSNode* pv_node = this->root;
+    while (pv_node) {
+        principal_variation.push_back(pv_node);
+
+        MCTSNode* most_simulations_child = nullptr;
+        uint32_t most_simulations = 0;
+
+        MCTSNode* current_child = this->pool.get(pv_node->first_child);
+        while (current_child) {
+            const auto simulations = current_child->get_half_wins_and_simulations().second;
+            if (simulations > most_simulations) {
+                most_simulations = simulations;
+                most_simulations_child = current_child;
+            }
+
+            current_child = this->pool.get(current_child->next_sibling);
+        }
+
+        pv_node = most_simulations_child;
+    }
+
+    const auto is_on_principal_variation = [&principal_variation](MCTSNode* node) {
+        return std::find(
+            principal_variation.begin(),
+            principal_variation.end(),
+            node
+        ) != principal_variation.end();
+    };
+
+    const std::size_t target_nodes = this->node_budget.get_count() / 4;
+    const uint64_t trace_start = this->trace_recorder ? this->trace_recorder->now() : 0;
+
+    PoolAllocator<MCTSNode>::LocalCache cache{this->pool};
+
+    std::size_t reclaimed = 0;
+    uint32_t simulations_threshold = 2;
+
+    // Collapse the least visited subtrees into leaves, raising the threshold
+    // until we have reclaimed enough nodes
+    while (reclaimed < target_nodes) {
+        std::vector<MCTSNode*> stack{this->root};
+        bool has_nodes_above_threshold = false;
+
+        while (!stack.empty()) {
+            MCTSNode* node = stack.back();
+            stack.pop_back();
+
+            MCTSNode* current_child = this->pool.get(node->first_child);
+            while (current_child) {
+                if (current_child->first_child) {
+                    const auto simulations = current_child->get_half_wins_and_simulations().second;
+
+                    // Proven nodes keep the children their proof and best move come from
+                    if (simulations < simulations_threshold
+                        && !is_on_principal_variation(current_child)
+                        && !current_child->get_proven_result()) {
+                        reclaimed += this->collapse_node(current_child, cache);
+                    } else {
+                        has_nodes_above_threshold = true;
+                        stack.push_back(current_child);
+                    }
+                }
+
+                current_child = this->pool.get(current_child->next_sibling);
+            }
+        }
+
+        if (!has_nodes_above_threshold) {
+            break;
+        }
+
+        simulations_threshold *= 2;
+    }
+
+    if (this->trace_recorder) {
+        this->trace_recorder->complete("prune tree", trace_start, reclaimed);
+    }
+
+    return reclaimed;
+}
+
+std::size_t MCTS::collapse_node(MCTSNode* node, PoolAllocator<MCTSNode>::LocalCache& cache) {
+    std::size_t freed = 0;
+
+    MCTSNode* current_child = this->pool.get(node->first_child);
+    while (current_child) {
+        MCTSNode* next_child = this->pool.get(current_child->next_sibling);
+
+        freed += TreeReclaimer::free_subtree(current_child, cache);
+
+        current_child = next_child;
+    }
+
+    // The node becomes a leaf again and will be expanded when selected
+    node->first_child = POOL_NULL_INDEX;
+    node->unexpanded_child.store(POOL_NULL_INDEX);
+    node->clear_flags(MCTSNode::IS_PARENT | MCTSNode::IS_EXPANDABLE | MCTSNode::IS_FULLY_EXPANDED);
+
+    this->node_budget.release(freed);
+
+    return freed;
+}
+
+std::size_t MCTS::get_reclaimed_nodes() const {
+    return this->reclaimed_nodes;
+}
+
+bool MCTS::uses_huge_pages() const {
+    return this->pool.uses_huge_pages();
+}
+
+void MCTS::apply_move(Move move) {
+    this->board_state.apply_move(move);
+
+    if (!this->root) {
+        return;
+    }
+
+    // The tree might be searching a symmetric orientation of the game
+    const auto tree_move = transform_move(move, this->tree_symmetry);
+
+    // Reuse part of the tree that we have from previous searches if possible
+    if (!this->compound_moves) {
+        MCTSNode* new_root = this->pool.get(this->root->first_child);
+        while (new_root && new_root->parent_move != tree_move) {
+            new_root = this->pool.get(new_root->next_sibling);
+        }
+
+        if (!new_root) {
+            new_root = this->find_symmetric_child();
+        }
+
+        this->reroot(new_root);
+        this->root_board_state = this->board_state.transformed(this->tree_symmetry);
+
+        return;
+    }
+
+    // The ring removal that follows completes one of the compound moves of the root
+    const auto* row_removal = std::get_if<RemoveRowMove>(&move);
+    if (row_removal && this->root_board_state.get_next_action() == NextAction::RowRemoval) {
+        this->pending_row_removal = *row_removal;
+        return;
+    }
+
+    this->pending_row_removal.reset();
+
+    // Moves of the tree skip forced removals, so we look for the child by its position
+    const auto tree_board_state = this->board_state.transformed(this->tree_symmetry);
+
+    MCTSNode* current_child = this->pool.get(this->root->first_child);
+    while (current_child) {
+        BoardState child_board_state = this->root_board_state;
+        child_board_state.apply_compound_move(current_child->parent_move);
+
+        if (child_board_state == tree_board_state) {
+            this->reroot(current_child);
+            this->root_board_state = child_board_state;
+
+            return;
+        }
+
+        current_child = this->pool.get(current_child->next_sibling);
+    }
+
+    if (MCTSNode* symmetric_child = this->find_symmetric_child()) {
+        this->reroot(symmetric_child);
+        this->root_board_state = this->board_state.transformed(this->tree_symmetry);
+
+        return;
+    }
+
+    // The game might be in the middle of removals the tree skips, we keep the tree
+    // and begin_search drops it if the game went somewhere else
+}
+
+MCTSNode* MCTS::find_symmetric_child() {
+    // Symmetric children are only merged during the ring placement
+    if (this->root_board_state.get_next_action() != NextAction::RingPlacement) {
+        return nullptr;
+    }
+
+    MCTSNode* current_child = this->pool.get(this->root->first_child);
+    while (current_child) {
+        BoardState child_board_state = this->root_board_state;
+        MCTS::apply_tree_move(child_board_state, current_child->parent_move, this->compound_moves);
+
+        for (uint8_t symmetry = 0; symmetry < SYMMETRY_COUNT; symmetry++) {
+            if (this->board_state.transformed(symmetry) == child_board_state) {
+                this->tree_symmetry = symmetry;
+                return current_child;
+            }
+        }
+
+        current_child = this->pool.get(current_child->next_sibling);
+    }
+
+    return nullptr;
+}
+
+Move MCTS::to_game_frame(Move tree_move) const {
+    return transform_move(tree_move, inverse_symmetry(this->tree_symmetry));
+}
+
+void MCTS::reroot(MCTSNode* new_root) {
+    // Unlink the new root from the children of the old root
+    if (new_root) {
+        PoolIndex* link = &this->root->first_child;
+        while (this->pool.get(*link) != new_root) {
+            link = &this->pool.get(*link)->next_sibling;
+        }
+
+        *link = new_root->next_sibling;
+    }
+
+    // The old root with the rest of its subtree is freed on the reclaim
+    // thread, so applying a move doesn't depend on the tree size
+    this->reclaimer.release(this->root, this->node_budget, this->trace_recorder);
+
+    if (this->trace_recorder) {
+        this->trace_recorder->instant("release tree");
+    }
+
+    if (new_root) {
+        new_root->next_sibling = POOL_NULL_INDEX;
+        new_root->parent = POOL_NULL_INDEX;
+    }
+
+    this->root = new_root;
+
+    // Cached board states are for nodes which are released now, and the new root is one level higher
+    if (this->board_cache) {
+        this->board_cache->invalidate();
+    }
+}
+
+std::optional<Move> MCTS::pending_ring_removal() const {
+    const auto pending_tree_row_removal = std::get<RemoveRowMove>(transform_move(*this->pending_row_removal, this->tree_symmetry));
+
+    MCTSNode* most_simulations_node = nullptr;
+    uint32_t most_simulations = 0;
+
+    MCTSNode* current_child = this->pool.get(this->root->first_child);
+    while (current_child) {
+        const auto* compound = std::get_if<RemoveRowAndRingMove>(&current_child->parent_move);
+        const auto simulations = current_child->get_half_wins_and_simulations().second;
+
+        if (compound
+            && RemoveRowMove{compound->from, compound->direction} == pending_tree_row_removal
+            && (!most_simulations_node || simulations > most_simulations)) {
+            most_simulations_node = current_child;
+            most_simulations = simulations;
+        }
+
+        current_child = this->pool.get(current_child->next_sibling);
+    }
+
+    if (!most_simulations_node) {
+        return std::nullopt;
+    }
+
+    return this->to_game_frame(RemoveRingMove{std::get<RemoveRowAndRingMove>(most_simulations_node->parent_move).ring});
+}
+
+void MCTS::set_compound_moves(bool enabled) {
+    if (this->root) {
+        this->reroot(nullptr);
+    }
+
+    this->compound_moves = enabled;
+    this->pending_row_removal.reset();
+}
+
+Move MCTS::to_game_move(Move tree_move) {
+    if (const auto* compound = std::get_if<RemoveRowAndRingMove>(&tree_move)) {
+        return RemoveRowMove{compound->from, compound->direction};
+    }
+
+    return tree_move;
+}
+
+void MCTS::apply_tree_move(BoardState& board_state, Move move, bool compound_moves) {
+    if (compound_moves) {
+        board_state.apply_compound_move(move);
+    } else {
+        board_state.apply_move(move);
+    }
+}
+
+void MCTS::set_board(BoardState board) {
+    // The tree is dropped by the next search if it doesn't belong to the board
+    this->board_state = board;
+    this->pending_row_removal.reset();
+}
+
+void MCTS::set_opening_book(const OpeningBook* opening_book) {
+    this->opening_book = opening_book;
+}
+
+void MCTS::set_trace_recorder(TraceRecorder* trace_recorder) {
+    this->trace_recorder = trace_recorder;
+}
+
+void MCTS::set_endgame_solver(EndgameSolverOptions options) {
+    if (options.table_bytes == 0) {
+        this->endgame_solver.reset();
+    } else {
+        this->endgame_solver = std::make_unique<EndgameSolver>(options);
+    }
+}
+
+void MCTS::set_board_cache(BoardCacheOptions options) {
+    if (options.capacity_bytes == 0) {
+        this->board_cache.reset();
+    } else {
+        this->board_cache = std::make_unique<BoardCache>(options);
+    }
+}
+
+BoardState MCTS::get_board() const {
+    return this->board_state;
+}
+
+MCTSNode* MCTS::get_root() const {
+    return this->root;
+}
+
+// Layout of the tree files, the header is followed by the nodes in preorder
+struct TreeFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint8_t tree_symmetry;
+    uint8_t compound_moves;
+    uint8_t has_pending_row_removal;
+    uint8_t padding;
+    uint64_t node_count;
+    uint32_t pending_row_removal;
+    uint32_t padding_2;
+    BoardState board_state;
+    BoardState root_board_state;
+};
+
+struct TreeFileNode {
+    uint64_t half_wins_and_simulations;
+    uint32_t parent_move;
+    uint16_t child_count;
+    // Children before this one were already added to the tree by selection
+    uint16_t expanded_child_count;
+    uint8_t flags;
+    Color color;
+    uint8_t padding[6];
+};
+
+static_assert(std::is_trivially_copyable_v<BoardState>);
+static_assert(sizeof(TreeFileNode) == 24);
+
+// The next search keeps only trees of the game position, except for a compound tree
+//   waiting for the ring removal of the pending row, which is a step behind the game
+static bool is_tree_of_board(const BoardState& board_state, const BoardState& root_board_state, uint8_t tree_symmetry, bool compound_moves, bool has_pending_row_removal) {
+    return board_state.transformed(tree_symmetry) == root_board_state || (compound_moves && has_pending_row_removal);
+}
+
+bool MCTS::save_tree(const std::string& file_path) const {
+    TreeFileHeader header{};
+    std::memcpy(header.magic, MCTS::TREE_FILE_MAGIC, sizeof(MCTS::TREE_FILE_MAGIC));
+    header.version = MCTS::TREE_FILE_VERSION;
+    header.tree_symmetry = this->tree_symmetry;
+    header.compound_moves = this->compound_moves;
+    header.has_pending_row_removal = this->pending_row_removal.has_value();
+    header.node_count = 0;
+    header.pending_row_removal = this->pending_row_removal ? encode_move(*this->pending_row_removal) : 0;
+    header.board_state = this->board_state;
+    header.root_board_state = this->root_board_state;
+
+    std::ofstream file{file_path, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Nodes are written in batches, one write per node makes saving big trees slow
+    constexpr std::size_t BATCH_NODES = 4096;
+    std::vector<TreeFileNode> batch;
+    batch.reserve(BATCH_NODES);
+
+    // A tree the next search would drop isn't saved, the file only keeps the game
+    std::vector<MCTSNode*> stack;
+    if (this->root && is_tree_of_board(this->board_state, this->root_board_state, this->tree_symmetry, this->compound_moves, this->pending_row_removal.has_value())) {
+        stack.push_back(this->root);
+    }
+
+    while (!stack.empty()) {
+        MCTSNode* node = stack.back();
+        stack.pop_back();
+
+        TreeFileNode record{};
+        record.half_wins_and_simulations = node->half_wins_and_simulations.load();
+        record.parent_move = encode_move(node->parent_move);
+        record.flags = node->flags.load();
+        record.color = node->color;
+
+        // Children are pushed in reverse, so they are popped and written in their order
+        const auto stack_size = stack.size();
+        const PoolIndex unexpanded_child = node->unexpanded_child.load();
+        bool is_expanded = true;
+
+        MCTSNode* current_child = this->pool.get(node->first_child);
+        while (current_child) {
+            if (this->pool.index_of(current_child) == unexpanded_child) {
+                is_expanded = false;
+            }
+
+            record.child_count++;
+            record.expanded_child_count += is_expanded;
+            stack.push_back(current_child);
+
+            current_child = this->pool.get(current_child->next_sibling);
+        }
+        std::reverse(stack.begin() + stack_size, stack.end());
+
+        batch.push_back(record);
+        header.node_count++;
+
+        if (batch.size() == BATCH_NODES || stack.empty()) {
+            file.write(reinterpret_cast<const char*>(batch.data()), batch.size() * sizeof(TreeFileNode));
+            batch.clear();
+        }
+    }
+
+    // The node count includes released subtrees the reclaimer didn't free yet, so we count the nodes ourselves
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    return file.good();
+}
+
+// Checks the whole file before anything of the engine is replaced: the header and both
+//   positions, that the nodes form one tree of legal moves, and that the flags of every
+//   node agree with its children, so the search can trust the tree as if it grew it
+static bool is_valid_tree_file(std::ifstream& file, const TreeFileHeader& header, std::size_t node_limit) {
+    if (std::memcmp(header.magic, MCTS::TREE_FILE_MAGIC, sizeof(MCTS::TREE_FILE_MAGIC)) != 0
+        || header.version != MCTS::TREE_FILE_VERSION
+        || header.tree_symmetry >= SYMMETRY_COUNT
+        || header.compound_moves > 1
+        || header.has_pending_row_removal > 1
+        || header.node_count > node_limit
+        || !header.board_state.is_valid()
+        || !header.root_board_state.is_valid()) {
+        return false;
+    }
+
+    if (header.has_pending_row_removal) {
+        const auto pending_row_removal = try_decode_move(header.pending_row_removal);
+        if (!pending_row_removal || !std::holds_alternative<RemoveRowMove>(*pending_row_removal)) {
+            return false;
+        }
+    }
+
+    if (header.node_count > 0
+        && !is_tree_of_board(header.board_state, header.root_board_state, header.tree_symmetry, header.compound_moves, header.has_pending_row_removal)) {
+        return false;
+    }
+
+    constexpr uint8_t KNOWN_FLAGS = MCTSNode::IS_PARENT | MCTSNode::IS_EXPANDABLE | MCTSNode::IS_FULLY_EXPANDED | MCTSNode::PROVEN_RESULT;
+    constexpr uint8_t CHILDREN_FLAGS = MCTSNode::IS_PARENT | MCTSNode::IS_EXPANDABLE;
+
+    // Parents on the path to the current node, with the children they still miss
+    struct Parent {
+        BoardState board_state;
+        MoveList move_list;
+        uint16_t missing_children;
+    };
+
+    std::vector<Parent> parents;
+
+    for (uint64_t node_index = 0; node_index < header.node_count; node_index++) {
+        TreeFileNode record;
+        file.read(reinterpret_cast<char*>(&record), sizeof(record));
+
+        // Only the root has no parent, the other nodes have to fit under it
+        if (!file
+            || (node_index > 0) == parents.empty()
+            || record.expanded_child_count > record.child_count
+            || record.color > Color::Black
+            || (record.flags & ~KNOWN_FLAGS) != 0) {
+            return false;
+        }
+
+        const auto move = try_decode_move(record.parent_move);
+        if (!move) {
+            return false;
+        }
+
+        BoardState board_state = header.root_board_state;
+
+        if (!parents.empty()) {
+            Parent& parent = parents.back();
+
+            bool is_legal = false;
+            for (std::size_t move_index = 0; move_index < parent.move_list.get_size(); move_index++) {
+                is_legal |= parent.move_list[move_index] == *move;
+            }
+
+            if (!is_legal || record.color != parent.board_state.whose_move()) {
+                return false;
+            }
+
+            board_state = parent.board_state;
+            if (header.compound_moves) {
+                board_state.apply_compound_move(*move);
+            } else {
+                board_state.apply_move(*move);
+            }
+
+            parent.missing_children--;
+
+            while (!parents.empty() && parents.back().missing_children == 0) {
+                parents.pop_back();
+            }
+        }
+
+        // Children are created all at once, and selection hands them out in order
+        const uint8_t children_flags = record.child_count > 0 ? CHILDREN_FLAGS : 0;
+        const bool is_fully_expanded = record.child_count > 0 && record.expanded_child_count == record.child_count;
+
+        if ((record.flags & CHILDREN_FLAGS) != children_flags
+            || ((record.flags & MCTSNode::IS_FULLY_EXPANDED) != 0) != is_fully_expanded) {
+            return false;
+        }
+
+        // Only the end of the game is proven without children, with the result it ended in
+        const uint8_t proven = (record.flags & MCTSNode::PROVEN_RESULT) >> 3;
+        if (proven != 0 && record.child_count == 0
+            && (board_state.get_next_action() != NextAction::Done || board_state.game_result() != static_cast<GameResult>(proven - 1))) {
+            return false;
+        }
+
+        if (record.child_count > 0) {
+            Parent parent{
+                .board_state = board_state,
+                .move_list = {},
+                .missing_children = record.child_count,
+            };
+
+            if (header.compound_moves) {
+                board_state.generate_compound_moves(parent.move_list);
+            } else {
+                board_state.generate_moves(parent.move_list);
+            }
+
+            parents.push_back(parent);
+        }
+    }
+
+    return parents.empty();
+}
+
+bool MCTS::load_tree(const std::string& file_path) {
+    std::ifstream file{file_path, std::ios::binary};
+
+    TreeFileHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (!file || !is_valid_tree_file(file, header, this->node_budget.get_limit())) {
+        return false;
+    }
+
+    file.clear();
+    file.seekg(sizeof(header));
+
+    if (this->search_thread.joinable()) {
+        this->search_thread.join();
+    }
+
+    if (this->root) {
+        this->reroot(nullptr);
+    }
+
+    this->board_state = header.board_state;
+    this->root_board_state = header.root_board_state;
+    this->tree_symmetry = header.tree_symmetry;
+    this->compound_moves = header.compound_moves;
+    this->pending_row_removal.reset();
+    if (header.has_pending_row_removal) {
+        this->pending_row_removal = std::get<RemoveRowMove>(decode_move(header.pending_row_removal));
+    }
+
+    if (header.node_count == 0) {
+        return true;
+    }
+
+    // Drops the old tree for real, so its nodes count neither against the budget nor the pool
+    this->reclaimer.wait_until_idle();
+
+    if (!this->node_budget.reserve(header.node_count)) {
+        return false;
+    }
+
+    struct Parent {
+        MCTSNode* node;
+        MCTSNode* last_child;
+        uint16_t child_count;
+        uint16_t expanded_child_count;
+        uint16_t added_child_count;
+    };
+
+    PoolAllocator<MCTSNode>::LocalCache cache{this->pool};
+    std::vector<Parent> parents;
+
+    bool failed = false;
+    for (uint64_t node_index = 0; node_index < header.node_count; node_index++) {
+        TreeFileNode record;
+        file.read(reinterpret_cast<char*>(&record), sizeof(record));
+
+        // Only the root has no parent, the other nodes have to fit under it
+        if (!file || (node_index > 0) == parents.empty()) {
+            failed = true;
+            break;
+        }
+
+        Parent* parent = parents.empty() ? nullptr : &parents.back();
+
+        MCTSNode* node = cache.allocate(
+            decode_move(record.parent_move),
+            parent ? this->pool.index_of(parent->node) : POOL_NULL_INDEX,
+            record.color
+        );
+
+        if (!node) {
+            failed = true;
+            break;
+        }
+
+        node->half_wins_and_simulations.store(record.half_wins_and_simulations);
+        node->flags.store(record.flags);
+
+        if (!parent) {
+            this->root = node;
+        } else {
+            if (parent->last_child) {
+                parent->last_child->next_sibling = this->pool.index_of(node);
+            } else {
+                parent->node->first_child = this->pool.index_of(node);
+            }
+
+            if (parent->added_child_count == parent->expanded_child_count) {
+                parent->node->unexpanded_child.store(this->pool.index_of(node));
+            }
+
+            parent->last_child = node;
+            parent->added_child_count++;
+
+            while (!parents.empty() && parents.back().added_child_count == parents.back().child_count) {
+                parents.pop_back();
+            }
+        }
+
+        if (record.child_count > 0) {
+            parents.push_back(Parent{
+                .node = node,
+                .last_child = nullptr,
+                .child_count = record.child_count,
+                .expanded_child_count = record.expanded_child_count,
+                .added_child_count = 0,
+            });
+        }
+    }
+
+    if (failed || !parents.empty()) {
+        if (this->root) {
+            TreeReclaimer::free_subtree(this->root, cache);
+            this->root = nullptr;
+        }
+
+        this->node_budget.release(header.node_count);
+
+        return false;
+    }
+
+    return true;
 }
 
-int MCTS::tree_size(MCTSNode* node) {
+int MCTS::tree_size(MCTSNode* node) const {
     if (!node) {
         return 0;
     }
 
     int children_sizes_sum = 0;
 
-    MCTSNode* current_child = node->first_child;
+    MCTSNode* current_child = this->pool.get(node->first_child);
     while (current_child) {
-        children_sizes_sum += MCTS::tree_size(current_child);
+        children_sizes_sum += this->tree_size(current_child);
 
-        current_child = current_child->next_sibling;
+        current_child = this->pool.get(current_child->next_sibling);
     }
 
     return children_sizes_sum + 1;
@@ -3,45 +3,249 @@
 
 #include <yngine/board_state.hpp>
 #include <yngine/allocators.hpp>
+#include <yngine/time_manager.hpp>
+#include <yngine/board_cache.hpp>
+#include <yngine/opening_book.hpp>
+#include <yngine/endgame_solver.hpp>
+#include <yngine/search_stats.hpp>
+#include <yngine/trace_recorder.hpp>
 
 #include <XoshiroCpp.hpp>
 
 #include <future>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <memory>
+#include <chrono>
+#include <variant>
+#include <functional>
+#include <string>
 
 namespace Yngine {
 
-struct MCTSNode {
-    MCTSNode(Move parent_move, MCTSNode* parent, Color color);
+// Counts the nodes of one tree and limits how many of them it can have
+class NodeBudget {
+public:
+    NodeBudget(std::size_t limit);
+
+    // Returns false without reserving anything if the limit would be exceeded
+    bool reserve(std::size_t count);
+    void release(std::size_t count);
+
+    std::size_t get_count() const;
+    std::size_t get_limit() const;
+
+private:
+    std::atomic<std::size_t> count;
+    const std::size_t limit;
+};
+
+// Int limit is the amount of iterations the root should have after the search
+// Float limit is the amount of seconds to search for
+// Time control limit lets the time manager decide how long to search for
+// Infinite limit searches until the search is stopped or the root is proven
+struct InfiniteLimit {};
+using SearchLimit = std::variant<int, float, TimeControl, InfiniteLimit>;
+
+// Hands out iterations of one search to the threads in chunks, so the threads
+//   neither read the clock nor the root statistics on every iteration
+class SearchBudget {
+public:
+    // Number of iterations claimed at once, the clock is checked once per chunk
+    static constexpr int CHUNK_ITERATIONS = 16;
+    // How often the time manager looks at the root statistics
+    static constexpr std::chrono::milliseconds TIME_CHECK_INTERVAL{10};
+
+    SearchBudget();
+
+    // Iteration limits count the iterations the root already has from previous searches.
+    //   Time limits are measured from the start time, which can be before the call
+    void start(SearchLimit limit, uint32_t root_simulations, std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now());
+    // Returns the number of iterations the calling thread has to perform,
+    //   zero once the budget is spent or the search was stopped
+    int claim(int max_iterations);
+    // Threads stop without finishing their claimed iterations
+    void stop();
+    bool is_stopped() const;
+
+    float get_elapsed_seconds() const;
+    uint32_t get_start_root_simulations() const;
+
+    // Returns true for only one of the threads once per check interval when
+    //   the search is managed by the time manager, that thread should call check_time
+    bool is_time_check_due();
+    void check_time(uint32_t root_simulations, uint32_t best_simulations, uint32_t second_simulations);
+
+private:
+    bool limits_iterations;
+    std::atomic<int64_t> remaining_iterations;
+
+    std::chrono::steady_clock::time_point start_time;
+    std::atomic<std::chrono::steady_clock::time_point> deadline;
+
+    std::optional<TimeManager> time_manager;
+    uint32_t start_root_simulations;
+    std::atomic<std::chrono::steady_clock::time_point> next_time_check;
+
+    std::atomic<bool> stopped;
+};
+
+// Nodes are kept to 32 bytes and aligned to it, so a node never spans two cache lines
+struct alignas(32) MCTSNode {
+    enum Flags : uint8_t {
+        IS_PARENT         = 1 << 0,
+        IS_EXPANDABLE     = 1 << 1,
+        IS_FULLY_EXPANDED = 1 << 2,
+
+        // Two bits holding the game result proven for this node plus one, zero if it's not proven
+        PROVEN_RESULT     = 3 << 3,
+    };
+
+    MCTSNode(Move parent_move, PoolIndex parent, Color color);
 
     std::pair<uint32_t, uint32_t> get_half_wins_and_simulations() const;
     float compute_uct(uint32_t parent_simulations) const;
-    void create_children(PoolAllocator<MCTSNode>& arena, XoshiroCpp::Xoshiro256StarStar& prng, BoardState board_state);
-    MCTSNode* add_child();
+    // Returns false only if the pool ran out of memory while allocating the children
+    bool create_children(PoolAllocator<MCTSNode>::LocalCache& cache, NodeBudget& budget, XoshiroCpp::Xoshiro256StarStar& prng, BoardState board_state, bool compound_moves);
+    MCTSNode* add_child(const PoolAllocator<MCTSNode>& pool);
     void add_half_wins_and_simulations(uint32_t half_wins, uint32_t simulations);
 
+    bool has_flags(uint8_t mask, std::memory_order order = std::memory_order_seq_cst) const;
+    // Returns the flags before they were set
+    uint8_t set_flags(uint8_t mask, std::memory_order order = std::memory_order_seq_cst);
+    void clear_flags(uint8_t mask);
+
+    std::optional<GameResult> get_proven_result() const;
+    void set_proven_result(GameResult result);
+
     std::atomic<uint64_t> half_wins_and_simulations;
-    std::atomic<bool> is_parent;
-    std::atomic<bool> is_expandable;
-    std::atomic<MCTSNode*> unexpanded_child;
-    std::atomic<bool> is_fully_expanded;
+    std::atomic<PoolIndex> unexpanded_child;
+
+    PoolIndex parent;
+    PoolIndex first_child;
+    PoolIndex next_sibling;
 
     const Move parent_move;
+    std::atomic<uint8_t> flags;
     const Color color;
+};
+
+static_assert(sizeof(MCTSNode) == 32);
+
+// Frees released subtrees on its own thread, so releasing a subtree takes constant time.
+//   Can be shared by all trees that allocate from the same pool
+class TreeReclaimer {
+public:
+    TreeReclaimer(PoolAllocator<MCTSNode>& pool);
+    ~TreeReclaimer();
+
+    TreeReclaimer(const TreeReclaimer &) = delete;
+    TreeReclaimer(TreeReclaimer &&) = delete;
+    TreeReclaimer &operator=(const TreeReclaimer &) = delete;
+    TreeReclaimer &operator=(TreeReclaimer &&) = delete;
+
+    // The freed nodes are released from the budget once the subtree is freed,
+    //   the freeing is traced if a recorder is given
+    void release(MCTSNode* subtree, NodeBudget& budget, TraceRecorder* trace_recorder = nullptr);
+    bool is_pending() const;
+    void wait_until_idle();
+
+    // Returns the number of freed nodes
+    static std::size_t free_subtree(MCTSNode* node, PoolAllocator<MCTSNode>::LocalCache& cache);
 
-    MCTSNode* parent;
-    MCTSNode* first_child;
-    MCTSNode* next_sibling;
+private:
+    struct Release {
+        PoolIndex subtree;
+        NodeBudget* budget;
+        TraceRecorder* trace_recorder;
+    };
+
+    void worker();
+
+    PoolAllocator<MCTSNode>& pool;
+
+    std::atomic<bool> pending;
+    bool stop;
+    std::vector<Release> queue;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::condition_variable idle_condition;
+    std::thread thread;
+};
+
+struct RootChildInfo {
+    Move move;
+    uint32_t simulations;
+    // From the point of view of the player making the move
+    float win_rate;
+    std::optional<GameResult> proven_result;
+};
+
+struct SearchInfo {
+    // False if the move was answered without a search, with the only legal move, the opening
+    //   book, the endgame solver, a proven root or the ring chosen together with the row.
+    //   All the other statistics are empty then
+    bool is_searched;
+    // Iterations performed by the search, the root might have more from previous searches
+    uint32_t iterations;
+    uint32_t root_simulations;
+    float elapsed_seconds;
+    float iterations_per_second;
+
+    // Nodes released with previous moves are counted until the reclaimer frees them
+    std::size_t tree_nodes;
+    std::size_t reclaimed_nodes;
+    std::size_t pool_used_bytes;
+    std::size_t pool_capacity_bytes;
+    std::size_t board_cache_bytes;
+
+    // Win rate of the best move for the side to move
+    float win_rate;
+    std::optional<GameResult> proven_result;
+    std::vector<Move> principal_variation;
+    std::vector<RootChildInfo> root_children;
+
+    // Phase times of the slices finished so far, see SearchStats
+    SearchStats search_stats;
+};
+
+class MCTS;
+
+// Controls a search running in the background
+class SearchHandle {
+public:
+    SearchHandle(MCTS& mcts, std::shared_future<Move> result);
+
+    // Stops the search as soon as possible, the search still picks a move
+    void stop();
+    bool is_done() const;
+    Move wait() const;
+
+    // Statistics of the search so far, can be called from any thread while the search runs
+    SearchInfo get_progress() const;
+    // Nothing if no move was searched yet
+    std::optional<Move> best_so_far() const;
+
+private:
+    MCTS* mcts;
+    std::shared_future<Move> result;
 };
 
 class MCTS {
 public:
-    // Int limit is the amount of iterations to perform,
-    //   right now it can perform up to (thread count - 1) more iterations that specified
-    // Float limit is the amount of seconds to search for
-    using SearchLimit = std::variant<int, float>;
+    using SearchLimit = Yngine::SearchLimit;
+
+    static constexpr std::size_t MAX_PRINCIPAL_VARIATION_LENGTH = 32;
+
+    static constexpr char TREE_FILE_MAGIC[8] = {'Y', 'N', 'G', 'T', 'R', 'E', 'E', '\0'};
+    static constexpr uint32_t TREE_FILE_VERSION = 1;
 
     // @TODO: move memory limit into search function?
-    MCTS(std::size_t memory_limit_bytes);
+    MCTS(std::size_t memory_limit_bytes, ArenaOptions arena_options = {});
+    // The tree allocates its nodes from a pool shared with other trees and can use up to memory quota of it
+    MCTS(PoolAllocator<MCTSNode>& shared_pool, TreeReclaimer& shared_reclaimer, std::size_t memory_quota_bytes);
     ~MCTS();
 
     MCTS(const MCTS &) = delete;
@@ -50,32 +254,163 @@ public:
     MCTS &operator=(MCTS &&) = delete;
 
     std::future<Move> search(SearchLimit search_limit, int thread_count=1);
+    // Like search, but the search can be stopped and queried through the handle. The progress
+    //   callback is called periodically on one of the search threads, so it should be quick
+    SearchHandle start_search(
+        SearchLimit search_limit,
+        int thread_count = 1,
+        std::function<void(const SearchInfo&)> progress_callback = {},
+        std::chrono::milliseconds progress_interval = std::chrono::milliseconds{100}
+    );
+    void stop();
+    // Statistics of the running search, empty before the first search
+    SearchInfo get_search_progress();
     void apply_move(Move move);
     void set_board(BoardState board);
     BoardState get_board() const;
     MCTSNode* get_root() const;
 
-    static int tree_size(MCTSNode* node);
+    // Writes the tree with the board to a file without any pool indices in it, so a restarted
+    //   process can continue from it. A tree the next search would drop because it doesn't
+    //   belong to the board is left out. Must not be called while searching
+    bool save_tree(const std::string& file_path) const;
+    // Replaces the tree and the board with the ones from the file. Returns false without changing
+    //   anything if the file isn't a valid tree. If the tree doesn't fit into the memory it returns
+    //   false as well, the board is the one of the file then and the tree is empty
+    bool load_tree(const std::string& file_path);
+
+    // Walks the whole subtree, use get_node_count for the size of the tree
+    int tree_size(MCTSNode* node) const;
+    std::size_t get_node_count() const;
+
+    // Statistics of the last search, empty until it finishes
+    SearchInfo get_search_info() const;
+    // Called with the statistics of every finished search on the thread that finished it
+    void set_search_info_callback(std::function<void(const SearchInfo&)> callback);
+
+    // Total number of nodes returned to the pool by pruning when it was exhausted
+    std::size_t get_reclaimed_nodes() const;
+    bool uses_huge_pages() const;
+
+    // Must not be called while searching, zero capacity disables the cache
+    void set_board_cache(BoardCacheOptions options);
+    // Makes a row removal and the following ring removal one compound move of the tree and
+    //   skips removals with only one option. Searches still return moves of the game.
+    //   Must not be called while searching, drops the tree
+    void set_compound_moves(bool enabled);
+    // Searches answer right away with the move of the book if it has the position.
+    //   The book isn't owned and can be shared by many trees, nullptr disables it
+    void set_opening_book(const OpeningBook* opening_book);
+    // Searches of endgame positions first try to solve them exactly, and play the solver's
+    //   move if it proves a win or a draw. Zero table size disables the solver. Searches
+    //   limited by time give the solve at most half of their time, searches limited by
+    //   iterations can take as long as max_nodes longer
+    void set_endgame_solver(EndgameSolverOptions options);
+    // Records searches, iteration batches, expansion failures, pruning and freeing of released
+    //   subtrees. The recorder isn't owned and has to outlive the tree, nullptr disables it.
+    //   Must not be called while searching
+    void set_trace_recorder(TraceRecorder* trace_recorder);
+
+    // Compound moves of the tree start with their row removal in the game
+    static Move to_game_move(Move tree_move);
+
+    // Search split into steps, so searches can also be run in slices on threads of a
+    //   SearchService. Returns the move right away if there is nothing to search
+    std::optional<Move> begin_search(SearchLimit limit);
+    // Can be called from any number of threads at once, returns the number of performed
+    //   iterations which is less than the maximum once the search limit is reached
+    int search_slice(int max_iterations, PoolAllocator<MCTSNode>::LocalCache& cache, XoshiroCpp::Xoshiro256StarStar& prng);
+    Move finish_search();
 
 private:
-    Move search_threaded(SearchLimit limit, int thread_count);
-    void search_worker(MCTSNode* root, SearchLimit limit);
+    std::future<Move> launch_search(
+        SearchLimit search_limit,
+        int thread_count,
+        std::function<void(const SearchInfo&)> progress_callback,
+        std::chrono::milliseconds progress_interval
+    );
+    Move search_threaded(int thread_count);
+    bool is_progress_report_due();
+    void search_worker();
+    void run_iteration(PoolAllocator<MCTSNode>::LocalCache& cache, XoshiroCpp::Xoshiro256StarStar& prng);
+    // Gives the time manager the visits of the two best root children
+    void check_time();
+    SearchInfo collect_search_info() const;
 
-    static std::tuple<MCTSNode*, BoardState> select(MCTSNode* root, BoardState root_board_state);
-    static MCTSNode* expand(MCTSNode* node, BoardState board_state, PoolAllocator<MCTSNode>& pool, XoshiroCpp::Xoshiro256StarStar& prng);
+    static void apply_tree_move(BoardState& board_state, Move move, bool compound_moves);
+    static std::tuple<MCTSNode*, BoardState> select(MCTSNode* root, const BoardState& root_board_state, const PoolAllocator<MCTSNode>& pool, BoardCache* board_cache, bool compound_moves);
+    // Brings the board state from the root to the last node of the path, starting from the deepest cached node
+    static void restore_board_state(MCTSNode* const* path, int depth, BoardState& board_state, const PoolAllocator<MCTSNode>& pool, BoardCache& board_cache, bool compound_moves);
+    // Applies the move of the expanded child to the board state
+    static MCTSNode* expand(MCTSNode* node, BoardState& board_state, PoolAllocator<MCTSNode>::LocalCache& cache, NodeBudget& budget, XoshiroCpp::Xoshiro256StarStar& prng, bool compound_moves, bool& out_of_memory);
     static GameResult playout(MCTSNode* node, BoardState board_state, XoshiroCpp::Xoshiro256StarStar& prng);
-    static void backup(MCTSNode* from, GameResult playout_result);
+    static void backup(MCTSNode* from, GameResult playout_result, const PoolAllocator<MCTSNode>& pool);
+    // Tries to prove the result of the node from its children, returns whether it succeeded
+    static bool prove_from_children(MCTSNode* node, const PoolAllocator<MCTSNode>& pool);
+    static void backup_proof(MCTSNode* from, const PoolAllocator<MCTSNode>& pool);
+    static MCTSNode* best_child(MCTSNode* node, const PoolAllocator<MCTSNode>& pool);
 
-    void free_subtree(MCTSNode* node);
+    // Workers pause here while the tree is pruned, the last worker to arrive does the pruning
+    void enter_search();
+    void wait_for_pruning();
+    void leave_search();
+    std::size_t prune_tree();
+    // Releases the tree except for the new root, which has to be a child of the root
+    void reroot(MCTSNode* new_root);
+    // Best ring to remove with the row removed by the last move, when the root has compound moves
+    std::optional<Move> pending_ring_removal() const;
+    // Finds the child with a position symmetric to the game and switches the tree to its orientation
+    MCTSNode* find_symmetric_child();
+    Move to_game_frame(Move tree_move) const;
+    std::size_t collapse_node(MCTSNode* node, PoolAllocator<MCTSNode>::LocalCache& cache);
 
     BoardState board_state;
+    // Position of the root, which can be behind the board state when the game is in
+    //   the middle of a compound move or of removals that the tree skips
+    BoardState root_board_state;
+    // Transforms positions of the game into the orientation searched by the tree
+    uint8_t tree_symmetry;
+    bool compound_moves;
+    std::optional<RemoveRowMove> pending_row_removal;
+    const OpeningBook* opening_book;
+    std::unique_ptr<EndgameSolver> endgame_solver;
+    TraceRecorder* trace_recorder;
+    // When begin_search started the search, in the time of the trace recorder
+    uint64_t trace_search_start;
+    // Failed expansions repeat on every iteration until the tree is pruned, only the first one is traced
+    std::atomic<bool> expansion_failure_traced;
+
+    // Only set when the tree doesn't share them with other trees
+    std::unique_ptr<PoolAllocator<MCTSNode>> owned_pool;
+    std::unique_ptr<TreeReclaimer> owned_reclaimer;
 
-    PoolAllocator<MCTSNode> pool;
+    PoolAllocator<MCTSNode>& pool;
+    TreeReclaimer& reclaimer;
+    NodeBudget node_budget;
+    std::unique_ptr<BoardCache> board_cache;
 
     MCTSNode* root;
 
-    std::atomic<bool> stop_search;
+    SearchBudget search_budget;
     std::thread search_thread;
+
+    SearchInfo search_info;
+    std::function<void(const SearchInfo&)> search_info_callback;
+
+    // Threads merge their statistics in at the end of every slice
+    SearchStats search_stats;
+    mutable std::mutex search_stats_mutex;
+
+    std::function<void(const SearchInfo&)> progress_callback;
+    std::chrono::milliseconds progress_interval;
+    std::atomic<std::chrono::steady_clock::time_point> next_progress_report;
+
+    std::atomic<bool> prune_requested;
+    bool can_prune;
+    int active_workers;
+    std::mutex prune_mutex;
+    std::condition_variable prune_condition;
+    std::atomic<std::size_t> reclaimed_nodes;
 };
 
 }
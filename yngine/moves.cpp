@@ -22,6 +22,86 @@ bool RemoveRowMove::operator==(const RemoveRowMove& rhs) const {
     return false;
 }
 
+bool RemoveRowAndRingMove::operator==(const RemoveRowAndRingMove& rhs) const {
+    return RemoveRowMove{this->from, this->direction} == RemoveRowMove{rhs.from, rhs.direction}
+        && this->ring == rhs.ring;
+}
+
+uint32_t encode_move(Move move) {
+    const uint32_t type = move.index();
+
+    return std::visit(variant_overloaded{
+        [type](PlaceRingMove move) -> uint32_t {
+            return type | (move.index << 8);
+        },
+        [type](RingMove move) -> uint32_t {
+            return type | (move.from << 8) | (move.to << 16) | ((uint32_t)move.direction << 24);
+        },
+        [type](RemoveRowMove move) -> uint32_t {
+            return type | (move.from << 8) | ((uint32_t)move.direction << 24);
+        },
+        [type](RemoveRingMove move) -> uint32_t {
+            return type | (move.index << 8);
+        },
+        [type](PassMove) -> uint32_t {
+            return type;
+        },
+        [type](RemoveRowAndRingMove move) -> uint32_t {
+            return type | (move.from << 8) | (move.ring << 16) | ((uint32_t)move.direction << 24);
+        },
+    }, move);
+}
+
+Move decode_move(uint32_t encoded_move) {
+    const uint8_t type = encoded_move;
+    const uint8_t first = encoded_move >> 8;
+    const uint8_t second = encoded_move >> 16;
+    const Direction direction = Direction(encoded_move >> 24);
+
+    switch (type) {
+    case 0: return PlaceRingMove{first};
+    case 1: return RingMove{first, second, direction};
+    case 2: return RemoveRowMove{first, direction};
+    case 3: return RemoveRingMove{first};
+    case 4: return PassMove{};
+    case 5: return RemoveRowAndRingMove{first, direction, second};
+    default: abort();
+    }
+}
+
+std::optional<Move> try_decode_move(uint32_t encoded_move) {
+    const uint8_t type = encoded_move;
+    const uint8_t first = encoded_move >> 8;
+    const uint8_t second = encoded_move >> 16;
+    const uint8_t direction = encoded_move >> 24;
+
+    bool is_valid;
+    switch (type) {
+    case 0:
+    case 3:
+        is_valid = Bitboard::is_index_in_game(first) && second == 0 && direction == 0;
+        break;
+    case 1:
+    case 5:
+        is_valid = Bitboard::is_index_in_game(first) && Bitboard::is_index_in_game(second) && direction < 6;
+        break;
+    case 2:
+        is_valid = Bitboard::is_index_in_game(first) && second == 0 && direction < 6;
+        break;
+    case 4:
+        is_valid = encoded_move == type;
+        break;
+    default:
+        is_valid = false;
+    }
+
+    if (!is_valid) {
+        return std::nullopt;
+    }
+
+    return decode_move(encoded_move);
+}
+
 std::size_t MoveList::get_size() const {
     return this->size;
 }
@@ -55,4 +135,9 @@ void MoveList::reset() {
     this->size = 0;
 }
 
+void MoveList::resize(std::size_t size) {
+    assert(size <= this->size);
+    this->size = size;
+}
+
 }
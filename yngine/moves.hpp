@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <array>
+#include <optional>
 #include <variant>
 
 namespace Yngine {
@@ -38,6 +39,16 @@ struct RemoveRingMove {
     bool operator==(const RemoveRingMove&) const = default;
 };
 
+// Removal of a row followed by the removal of a ring of the same player. Never generated
+// for the game itself, the search tree uses it to make both removals one level of the tree
+struct RemoveRowAndRingMove {
+    uint8_t from;
+    Direction direction;
+    uint8_t ring;
+
+    bool operator==(const RemoveRowAndRingMove&) const;
+};
+
 // We need this for a very rare situation where the current player cannot make any
 // legal moves with their rings. That case is not mentioned in the official rules,
 // but the author of the game clarified that that player should pass their move
@@ -50,9 +61,16 @@ using Move = std::variant<
     RingMove,
     RemoveRowMove,
     RemoveRingMove,
-    PassMove
+    PassMove,
+    RemoveRowAndRingMove
 >;
 
+// Packs a move into 32 bits for files, the variant index is in the lowest byte
+uint32_t encode_move(Move move);
+Move decode_move(uint32_t encoded_move);
+// Empty for data no move encodes to, for moves read from files
+std::optional<Move> try_decode_move(uint32_t encoded_move);
+
 constexpr std::size_t MOVE_LIST_NUMBER = 128;
 
 class MoveList {
@@ -61,6 +79,8 @@ public:
     Move get_random(XoshiroCpp::Xoshiro256StarStar& prng) const;
     void append(Move move);
     void reset();
+    // Can only shrink the list
+    void resize(std::size_t size);
 
     Move& operator[](std::size_t index);
     Move operator[](std::size_t index) const;
@@ -0,0 +1,165 @@
+#include <yngine/opening_book.hpp>
+#include <yngine/symmetry.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__linux__) || defined(EMSCRIPTEN)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <Windows.h>
+#else
+static_assert(false);
+#endif
+
+namespace Yngine {
+
+std::unique_ptr<OpeningBook> OpeningBook::open(const std::string& file_path) {
+#if defined(__linux__) || defined(EMSCRIPTEN)
+    const int file = ::open(file_path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return nullptr;
+    }
+
+    struct stat file_stat;
+    if (fstat(file, &file_stat) != 0 || file_stat.st_size < (off_t)sizeof(Header)) {
+        close(file);
+        return nullptr;
+    }
+
+    const std::size_t mapping_size = file_stat.st_size;
+    void* mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+    // The mapping keeps the file alive on its own
+    close(file);
+
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+#elif defined(_WIN32)
+    const HANDLE file = CreateFileA(
+        file_path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart < (LONGLONG)sizeof(Header)) {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    const std::size_t mapping_size = file_size.QuadPart;
+    const HANDLE file_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (file_mapping == nullptr) {
+        return nullptr;
+    }
+
+    void* mapping = MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(file_mapping);
+
+    if (mapping == nullptr) {
+        return nullptr;
+    }
+#endif
+
+    // Using the constructor from here makes sure the mapping is released on every error below
+    std::unique_ptr<OpeningBook> book{new OpeningBook{mapping, mapping_size}};
+
+    if (mapping_size < sizeof(Header)) {
+        return nullptr;
+    }
+
+    const auto* header = static_cast<const Header*>(mapping);
+    if (std::memcmp(header->magic, OpeningBook::MAGIC, sizeof(OpeningBook::MAGIC)) != 0
+        || header->version != OpeningBook::VERSION
+        || header->entry_count != (mapping_size - sizeof(Header)) / sizeof(Entry)
+        || (mapping_size - sizeof(Header)) % sizeof(Entry) != 0) {
+        return nullptr;
+    }
+
+    const auto* entries = reinterpret_cast<const Entry*>(header + 1);
+
+    // Lookups decode the moves without checks, so a book with any broken entry isn't used at all
+    for (uint64_t entry_index = 0; entry_index < header->entry_count; entry_index++) {
+        if (!try_decode_move(entries[entry_index].move)) {
+            return nullptr;
+        }
+    }
+
+    book->entries = entries;
+    book->entry_count = header->entry_count;
+
+    return book;
+}
+
+bool OpeningBook::write(const std::string& file_path, std::vector<Entry> entries) {
+    std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+        return lhs.key < rhs.key;
+    });
+
+    Header header{};
+    std::memcpy(header.magic, OpeningBook::MAGIC, sizeof(OpeningBook::MAGIC));
+    header.version = OpeningBook::VERSION;
+    header.entry_count = entries.size();
+
+    std::ofstream file{file_path, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+
+    return file.good();
+}
+
+uint64_t OpeningBook::position_key(const BoardState& board_state) {
+    return board_state.canonical().first.hash();
+}
+
+OpeningBook::OpeningBook(void* mapping, std::size_t mapping_size)
+    : mapping{mapping}
+    , mapping_size{mapping_size}
+    , entries{nullptr}
+    , entry_count{0} {
+}
+
+OpeningBook::~OpeningBook() {
+#if defined(__linux__) || defined(EMSCRIPTEN)
+    munmap(this->mapping, this->mapping_size);
+#elif defined(_WIN32)
+    UnmapViewOfFile(this->mapping);
+#endif
+}
+
+std::optional<Move> OpeningBook::lookup(const BoardState& board_state) const {
+    const auto [canonical_board_state, symmetry] = board_state.canonical();
+    const auto key = canonical_board_state.hash();
+
+    const auto* entries_end = this->entries + this->entry_count;
+    const auto* entry = std::lower_bound(this->entries, entries_end, key, [](const Entry& entry, uint64_t key) {
+        return entry.key < key;
+    });
+
+    if (entry == entries_end || entry->key != key) {
+        return std::nullopt;
+    }
+
+    return transform_move(decode_move(entry->move), inverse_symmetry(symmetry));
+}
+
+std::size_t OpeningBook::get_entry_count() const {
+    return this->entry_count;
+}
+
+}
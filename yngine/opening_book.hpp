@@ -0,0 +1,69 @@
+#ifndef YNGINE_OPENING_BOOK_HPP
+#define YNGINE_OPENING_BOOK_HPP
+
+#include <yngine/board_state.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Yngine {
+
+// Read only book of precomputed moves, memory mapped from a file. Positions are
+//   stored in their canonical orientation, so one entry answers all symmetric positions
+class OpeningBook {
+public:
+    static constexpr char MAGIC[8] = {'Y', 'N', 'G', 'B', 'O', 'O', 'K', '\0'};
+    static constexpr uint32_t VERSION = 1;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t entry_count;
+    };
+
+    // Entries follow the header, sorted by the key
+    struct Entry {
+        // Hash of the canonical orientation of the position
+        uint64_t key;
+        // Encoded move in the canonical orientation
+        uint32_t move;
+        // Win rate of the move for the player making it, as found by the search
+        float win_rate;
+    };
+
+    static_assert(sizeof(Header) == 16);
+    static_assert(sizeof(Entry) == 16);
+
+    // Returns nullptr if the file can't be mapped or isn't a book
+    static std::unique_ptr<OpeningBook> open(const std::string& file_path);
+    // Sorts the entries and writes them as a book, returns false if the file can't be written
+    static bool write(const std::string& file_path, std::vector<Entry> entries);
+
+    static uint64_t position_key(const BoardState& board_state);
+
+    ~OpeningBook();
+
+    OpeningBook(const OpeningBook &) = delete;
+    OpeningBook(OpeningBook &&) = delete;
+    OpeningBook &operator=(const OpeningBook &) = delete;
+    OpeningBook &operator=(OpeningBook &&) = delete;
+
+    // The move is in the orientation of the given position
+    std::optional<Move> lookup(const BoardState& board_state) const;
+    std::size_t get_entry_count() const;
+
+private:
+    OpeningBook(void* mapping, std::size_t mapping_size);
+
+    void* mapping;
+    std::size_t mapping_size;
+
+    const Entry* entries;
+    std::size_t entry_count;
+};
+
+}
+
+#endif // YNGINE_OPENING_BOOK_HPP
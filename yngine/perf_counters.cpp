@@ -0,0 +1,216 @@
+#include <yngine/perf_counters.hpp>
+
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Yngine {
+
+uint64_t PerfCounterValues::get(PerfCounter counter) const {
+    return this->values[static_cast<std::size_t>(counter)];
+}
+
+PerfCounterValues PerfCounterValues::operator-(const PerfCounterValues& rhs) const {
+    PerfCounterValues result;
+    for (std::size_t counter_index = 0; counter_index < PERF_COUNTER_COUNT; counter_index++) {
+        result.values[counter_index] = this->values[counter_index] - rhs.values[counter_index];
+    }
+    return result;
+}
+
+PerfCounterValues& PerfCounterValues::operator+=(const PerfCounterValues& rhs) {
+    for (std::size_t counter_index = 0; counter_index < PERF_COUNTER_COUNT; counter_index++) {
+        this->values[counter_index] += rhs.values[counter_index];
+    }
+    return *this;
+}
+
+#ifdef __linux__
+
+static perf_event_attr counter_attributes(PerfCounter counter) {
+    perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+
+    attributes.size = sizeof(attributes);
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch (counter) {
+    case PerfCounter::Cycles:
+        attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case PerfCounter::Instructions:
+        attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case PerfCounter::BranchMisses:
+        attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    case PerfCounter::L1DataMisses:
+        attributes.type = PERF_TYPE_HW_CACHE;
+        attributes.config =
+            PERF_COUNT_HW_CACHE_L1D |
+            PERF_COUNT_HW_CACHE_OP_READ << 8 |
+            PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+        break;
+    case PerfCounter::LastLevelCacheMisses:
+        attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    default:
+        abort();
+    }
+
+    return attributes;
+}
+
+PerfCounterGroup::PerfCounterGroup()
+    : leader_fd{-1}
+    , opened_count{0} {
+    for (std::size_t counter_index = 0; counter_index < PERF_COUNTER_COUNT; counter_index++) {
+        this->fds[counter_index] = -1;
+        this->read_positions[counter_index] = -1;
+
+        auto attributes = counter_attributes(static_cast<PerfCounter>(counter_index));
+
+        // The leader starts and stops the whole group
+        attributes.disabled = this->leader_fd == -1 ? 1 : 0;
+
+        const int fd = syscall(SYS_perf_event_open, &attributes, 0, -1, this->leader_fd, 0);
+        if (fd == -1) {
+            continue;
+        }
+
+        if (this->leader_fd == -1) {
+            this->leader_fd = fd;
+        }
+
+        this->fds[counter_index] = fd;
+        this->read_positions[counter_index] = this->opened_count++;
+    }
+
+    this->start();
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+    for (const int fd : this->fds) {
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+}
+
+bool PerfCounterGroup::is_available() const {
+    return this->leader_fd != -1;
+}
+
+bool PerfCounterGroup::is_counting(PerfCounter counter) const {
+    return this->fds[static_cast<std::size_t>(counter)] != -1;
+}
+
+void PerfCounterGroup::start() {
+    if (this->leader_fd == -1) {
+        return;
+    }
+
+    ioctl(this->leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(this->leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void PerfCounterGroup::stop() {
+    if (this->leader_fd == -1) {
+        return;
+    }
+
+    ioctl(this->leader_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounterValues PerfCounterGroup::read() const {
+    PerfCounterValues result{};
+
+    if (this->leader_fd == -1) {
+        return result;
+    }
+
+    // Layout of a group read with both times
+    struct {
+        uint64_t count;
+        uint64_t time_enabled;
+        uint64_t time_running;
+        uint64_t values[PERF_COUNTER_COUNT];
+    } group;
+
+    if (::read(this->leader_fd, &group, sizeof(group)) <= 0 || group.time_running == 0) {
+        return result;
+    }
+
+    const double scale = static_cast<double>(group.time_enabled) / group.time_running;
+
+    for (std::size_t counter_index = 0; counter_index < PERF_COUNTER_COUNT; counter_index++) {
+        const int position = this->read_positions[counter_index];
+        if (position != -1 && static_cast<uint64_t>(position) < group.count) {
+            result.values[counter_index] = group.values[position] * scale;
+        }
+    }
+
+    return result;
+}
+
+#else
+
+PerfCounterGroup::PerfCounterGroup()
+    : leader_fd{-1}
+    , opened_count{0} {
+    for (std::size_t counter_index = 0; counter_index < PERF_COUNTER_COUNT; counter_index++) {
+        this->fds[counter_index] = -1;
+        this->read_positions[counter_index] = -1;
+    }
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+}
+
+bool PerfCounterGroup::is_available() const {
+    return false;
+}
+
+bool PerfCounterGroup::is_counting(PerfCounter counter) const {
+    return false;
+}
+
+void PerfCounterGroup::start() {
+}
+
+void PerfCounterGroup::stop() {
+}
+
+PerfCounterValues PerfCounterGroup::read() const {
+    return PerfCounterValues{};
+}
+
+#endif
+
+const char* PerfCounterGroup::counter_name(PerfCounter counter) {
+    switch (counter) {
+    case PerfCounter::Cycles:
+        return "cycles";
+    case PerfCounter::Instructions:
+        return "instructions";
+    case PerfCounter::BranchMisses:
+        return "branch misses";
+    case PerfCounter::L1DataMisses:
+        return "L1 data misses";
+    case PerfCounter::LastLevelCacheMisses:
+        return "LLC misses";
+    default:
+        abort();
+    }
+}
+
+}
@@ -0,0 +1,63 @@
+#ifndef YNGINE_PERF_COUNTERS_HPP
+#define YNGINE_PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Yngine {
+
+enum class PerfCounter : uint8_t {
+    Cycles,
+    Instructions,
+    BranchMisses,
+    L1DataMisses,
+    LastLevelCacheMisses,
+};
+
+constexpr std::size_t PERF_COUNTER_COUNT = 5;
+
+struct PerfCounterValues {
+    uint64_t values[PERF_COUNTER_COUNT];
+
+    uint64_t get(PerfCounter counter) const;
+
+    PerfCounterValues operator-(const PerfCounterValues& rhs) const;
+    PerfCounterValues& operator+=(const PerfCounterValues& rhs);
+};
+
+// Hardware counters of the calling thread read together as one perf_event_open group.
+//   Counting starts when the group is created. Counters the kernel or the CPU doesn't
+//   permit read as zero, and without any of them the whole group does nothing
+class PerfCounterGroup {
+public:
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(const PerfCounterGroup &) = delete;
+    PerfCounterGroup(PerfCounterGroup &&) = delete;
+    PerfCounterGroup &operator=(const PerfCounterGroup &) = delete;
+    PerfCounterGroup &operator=(PerfCounterGroup &&) = delete;
+
+    bool is_available() const;
+    bool is_counting(PerfCounter counter) const;
+
+    // Sets the counters to zero and counts from now on
+    void start();
+    void stop();
+    // Counts since the start, scaled up if the kernel had to share the counters with other groups
+    PerfCounterValues read() const;
+
+    static const char* counter_name(PerfCounter counter);
+
+private:
+    // Descriptors of the opened counters, the first opened one leads the group
+    int fds[PERF_COUNTER_COUNT];
+    int leader_fd;
+    // Position of every opened counter in the values read from the group
+    int read_positions[PERF_COUNTER_COUNT];
+    int opened_count;
+};
+
+}
+
+#endif // YNGINE_PERF_COUNTERS_HPP
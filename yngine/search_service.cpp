@@ -0,0 +1,242 @@
+#include <yngine/search_service.hpp>
+
+#include <random>
+#include <algorithm>
+#include <cassert>
+
+namespace Yngine {
+
+SearchService::Session::Session(PoolAllocator<MCTSNode>& pool, TreeReclaimer& reclaimer, std::size_t memory_quota_bytes)
+    : mcts{pool, reclaimer, memory_quota_bytes}
+    , searching{false}
+    , limit_reached{false}
+    , running_slices{0}
+    , search_count{0}
+    , last_search_seconds{0.0f}
+    , total_search_seconds{0.0f} {
+}
+
+SearchService::SearchService(std::size_t memory_limit_bytes, int thread_count, ArenaOptions arena_options)
+    : pool{memory_limit_bytes, arena_options}
+    , reclaimer{pool}
+    , next_session_id{0}
+    , stop{false}
+    , total_iterations{0}
+    , running_slices{0}
+    , busy_start_time{}
+    , busy_time{0} {
+    for (int thread_index = 0; thread_index < thread_count; thread_index++) {
+        this->workers.push_back(std::thread{&SearchService::worker, this});
+    }
+}
+
+SearchService::~SearchService() {
+    {
+        std::unique_lock lock{this->mutex};
+        this->stop = true;
+    }
+
+    this->condition.notify_all();
+    for (auto& worker : this->workers) {
+        worker.join();
+    }
+}
+
+SearchService::SessionId SearchService::create_session(std::size_t memory_quota_bytes) {
+    std::unique_lock lock{this->mutex};
+
+    const SessionId session_id = this->next_session_id++;
+    this->sessions.emplace(
+        session_id,
+        std::make_unique<Session>(this->pool, this->reclaimer, memory_quota_bytes)
+    );
+
+    return session_id;
+}
+
+void SearchService::close_session(SessionId session_id) {
+    std::unique_ptr<Session> session;
+
+    {
+        std::unique_lock lock{this->mutex};
+
+        auto it = this->sessions.find(session_id);
+        assert(it != this->sessions.end());
+        assert(!it->second->searching);
+
+        session = std::move(it->second);
+        this->sessions.erase(it);
+    }
+
+    // Destroying the tree waits for the reclaimer, so we do it without holding the lock
+    session.reset();
+}
+
+std::future<Move> SearchService::search(SessionId session_id, MCTS::SearchLimit search_limit) {
+    std::unique_lock lock{this->mutex};
+
+    Session& session = this->get_session(session_id);
+    assert(!session.searching);
+
+    session.promise = std::promise<Move>{};
+    auto future = session.promise.get_future();
+    session.search_start_time = std::chrono::steady_clock::now();
+
+    if (const auto move = session.mcts.begin_search(search_limit)) {
+        this->finish_search(session, *move);
+        return future;
+    }
+
+    session.searching = true;
+    session.limit_reached = false;
+    this->ready_sessions.push_back(&session);
+
+    lock.unlock();
+    this->condition.notify_all();
+
+    return future;
+}
+
+void SearchService::apply_move(SessionId session_id, Move move) {
+    std::unique_lock lock{this->mutex};
+
+    Session& session = this->get_session(session_id);
+    assert(!session.searching);
+
+    session.mcts.apply_move(move);
+}
+
+void SearchService::set_board(SessionId session_id, BoardState board) {
+    std::unique_lock lock{this->mutex};
+
+    Session& session = this->get_session(session_id);
+    assert(!session.searching);
+
+    session.mcts.set_board(board);
+}
+
+BoardState SearchService::get_board(SessionId session_id) const {
+    std::unique_lock lock{this->mutex};
+
+    return this->get_session(session_id).mcts.get_board();
+}
+
+uint64_t SearchService::get_total_iterations() const {
+    return this->total_iterations;
+}
+
+float SearchService::get_playouts_per_second() const {
+    std::unique_lock lock{this->mutex};
+
+    auto busy_time = this->busy_time;
+    if (this->running_slices > 0) {
+        busy_time += std::chrono::steady_clock::now() - this->busy_start_time;
+    }
+
+    const auto busy_seconds = std::chrono::duration<float>(busy_time).count();
+    if (busy_seconds <= 0.0f) {
+        return 0.0f;
+    }
+
+    return this->total_iterations / busy_seconds;
+}
+
+SearchService::SessionStats SearchService::get_session_stats(SessionId session_id) const {
+    std::unique_lock lock{this->mutex};
+
+    const Session& session = this->get_session(session_id);
+
+    return SessionStats{
+        .search_count = session.search_count,
+        .last_search_seconds = session.last_search_seconds,
+        .mean_search_seconds = session.search_count > 0
+            ? session.total_search_seconds / session.search_count
+            : 0.0f,
+    };
+}
+
+SearchInfo SearchService::get_search_info(SessionId session_id) const {
+    std::unique_lock lock{this->mutex};
+
+    const Session& session = this->get_session(session_id);
+    assert(!session.searching);
+
+    return session.mcts.get_search_info();
+}
+
+void SearchService::worker() {
+    std::random_device rd;
+    XoshiroCpp::Xoshiro256StarStar prng((static_cast<uint64_t>(rd()) << 32) | rd());
+
+    // The cache lives as long as the worker, so slices of different sessions reuse its slots
+    PoolAllocator<MCTSNode>::LocalCache cache{this->pool};
+
+    std::unique_lock lock{this->mutex};
+
+    while (true) {
+        this->condition.wait(lock, [this] {
+            return this->stop || !this->ready_sessions.empty();
+        });
+
+        if (this->stop) {
+            return;
+        }
+
+        // Put the session back right away, so other workers can search it at the same time
+        Session& session = *this->ready_sessions.front();
+        this->ready_sessions.pop_front();
+        this->ready_sessions.push_back(&session);
+
+        session.running_slices++;
+
+        if (this->running_slices++ == 0) {
+            this->busy_start_time = std::chrono::steady_clock::now();
+        }
+
+        lock.unlock();
+        const int iterations = session.mcts.search_slice(SearchService::SLICE_ITERATIONS, cache, prng);
+        this->total_iterations += iterations;
+        lock.lock();
+
+        session.running_slices--;
+
+        if (--this->running_slices == 0) {
+            this->busy_time += std::chrono::steady_clock::now() - this->busy_start_time;
+        }
+
+        if (iterations < SearchService::SLICE_ITERATIONS && !session.limit_reached) {
+            session.limit_reached = true;
+            std::erase(this->ready_sessions, &session);
+        }
+
+        // The last slice to finish picks the move
+        if (session.limit_reached && session.running_slices == 0) {
+            lock.unlock();
+            const auto move = session.mcts.finish_search();
+            lock.lock();
+
+            this->finish_search(session, move);
+        }
+    }
+}
+
+SearchService::Session& SearchService::get_session(SessionId session_id) const {
+    auto it = this->sessions.find(session_id);
+    assert(it != this->sessions.end());
+
+    return *it->second;
+}
+
+void SearchService::finish_search(Session& session, Move move) {
+    const auto elapsed = std::chrono::steady_clock::now() - session.search_start_time;
+    const auto elapsed_seconds = std::chrono::duration<float>(elapsed).count();
+
+    session.search_count++;
+    session.last_search_seconds = elapsed_seconds;
+    session.total_search_seconds += elapsed_seconds;
+
+    session.searching = false;
+    session.promise.set_value(move);
+}
+
+}
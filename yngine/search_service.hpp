@@ -0,0 +1,99 @@
+#ifndef YNGINE_SEARCH_SERVICE_HPP
+#define YNGINE_SEARCH_SERVICE_HPP
+
+#include <yngine/mcts.hpp>
+
+#include <deque>
+#include <unordered_map>
+
+namespace Yngine {
+
+// Hosts searches of many games at once. Searches of all sessions are split into
+//   slices which are run on one shared set of worker threads, and all trees
+//   allocate their nodes from one shared pool, each tree up to its session quota
+class SearchService {
+public:
+    using SessionId = uint32_t;
+
+    // Number of iterations a worker performs on a session before moving on to the next one
+    static constexpr int SLICE_ITERATIONS = 64;
+
+    struct SessionStats {
+        std::size_t search_count;
+        // Time from the search request until the move is ready
+        float last_search_seconds;
+        float mean_search_seconds;
+    };
+
+    SearchService(std::size_t memory_limit_bytes, int thread_count, ArenaOptions arena_options = {});
+    ~SearchService();
+
+    SearchService(const SearchService &) = delete;
+    SearchService(SearchService &&) = delete;
+    SearchService &operator=(const SearchService &) = delete;
+    SearchService &operator=(SearchService &&) = delete;
+
+    SessionId create_session(std::size_t memory_quota_bytes);
+    // The session must not be searching
+    void close_session(SessionId session_id);
+
+    // Only one search per session can run at a time
+    std::future<Move> search(SessionId session_id, MCTS::SearchLimit search_limit);
+    void apply_move(SessionId session_id, Move move);
+    void set_board(SessionId session_id, BoardState board);
+    BoardState get_board(SessionId session_id) const;
+
+    uint64_t get_total_iterations() const;
+    // Iterations of all sessions per second of the time any slice was running, so idle
+    //   time between the searches doesn't lower the rate
+    float get_playouts_per_second() const;
+    SessionStats get_session_stats(SessionId session_id) const;
+    // Statistics of the last search of the session, empty until it finishes
+    SearchInfo get_search_info(SessionId session_id) const;
+
+private:
+    struct Session {
+        Session(PoolAllocator<MCTSNode>& pool, TreeReclaimer& reclaimer, std::size_t memory_quota_bytes);
+
+        MCTS mcts;
+
+        bool searching;
+        // Set once a slice reached the search limit, no more slices are started after that
+        bool limit_reached;
+        int running_slices;
+        std::promise<Move> promise;
+        std::chrono::steady_clock::time_point search_start_time;
+
+        std::size_t search_count;
+        float last_search_seconds;
+        float total_search_seconds;
+    };
+
+    void worker();
+    Session& get_session(SessionId session_id) const;
+    void finish_search(Session& session, Move move);
+
+    PoolAllocator<MCTSNode> pool;
+    TreeReclaimer reclaimer;
+
+    std::unordered_map<SessionId, std::unique_ptr<Session>> sessions;
+    SessionId next_session_id;
+
+    // Sessions with searches that need more slices, in round-robin order
+    std::deque<Session*> ready_sessions;
+
+    bool stop;
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::thread> workers;
+
+    std::atomic<uint64_t> total_iterations;
+    // Slices running on all sessions, the service is busy while there is any
+    int running_slices;
+    std::chrono::steady_clock::time_point busy_start_time;
+    std::chrono::steady_clock::duration busy_time;
+};
+
+}
+
+#endif // YNGINE_SEARCH_SERVICE_HPP
@@ -0,0 +1,47 @@
+#include <yngine/search_stats.hpp>
+
+#include <cstdlib>
+
+namespace Yngine {
+
+void SearchStats::merge(const SearchStats& other) {
+    for (std::size_t phase_index = 0; phase_index < SEARCH_PHASE_COUNT; phase_index++) {
+        this->phase_ticks[phase_index] += other.phase_ticks[phase_index];
+        this->phase_calls[phase_index] += other.phase_calls[phase_index];
+        this->phase_counters[phase_index] += other.phase_counters[phase_index];
+    }
+
+    for (std::size_t event_index = 0; event_index < SEARCH_EVENT_COUNT; event_index++) {
+        this->events[event_index] += other.events[event_index];
+    }
+}
+
+const char* SearchStats::phase_name(SearchPhase phase) {
+    switch (phase) {
+    case SearchPhase::Select:
+        return "select";
+    case SearchPhase::Expand:
+        return "expand";
+    case SearchPhase::Playout:
+        return "playout";
+    case SearchPhase::Backup:
+        return "backup";
+    default:
+        abort();
+    }
+}
+
+const char* SearchStats::event_name(SearchEvent event) {
+    switch (event) {
+    case SearchEvent::ParentRaceLost:
+        return "parent race lost";
+    case SearchEvent::ChildRaceLost:
+        return "child race lost";
+    case SearchEvent::AllocationFailed:
+        return "allocation failed";
+    default:
+        abort();
+    }
+}
+
+}
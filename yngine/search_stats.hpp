@@ -0,0 +1,145 @@
+#ifndef YNGINE_SEARCH_STATS_HPP
+#define YNGINE_SEARCH_STATS_HPP
+
+#include <yngine/perf_counters.hpp>
+
+#include <cstdint>
+#include <cstddef>
+
+#ifdef YNGINE_SEARCH_STATS
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace Yngine {
+
+#ifdef YNGINE_SEARCH_STATS
+constexpr bool SEARCH_STATS_ENABLED = true;
+#else
+constexpr bool SEARCH_STATS_ENABLED = false;
+#endif
+
+#ifdef YNGINE_SEARCH_PERF_COUNTERS
+constexpr bool SEARCH_PERF_COUNTERS_ENABLED = true;
+#else
+constexpr bool SEARCH_PERF_COUNTERS_ENABLED = false;
+#endif
+
+enum class SearchPhase : uint8_t {
+    Select,
+    Expand,
+    Playout,
+    Backup,
+};
+
+constexpr std::size_t SEARCH_PHASE_COUNT = 4;
+
+enum class SearchEvent : uint8_t {
+    // Another thread was still creating the children of the selected node
+    ParentRaceLost,
+    // Other threads took all unexpanded children of the selected node
+    ChildRaceLost,
+    // The pool or the node budget had no room for the children
+    AllocationFailed,
+};
+
+constexpr std::size_t SEARCH_EVENT_COUNT = 3;
+
+// Where the iterations of a search spent their time and how often the rare cases of
+//   expansion happened. All zero unless the library is built with YNGINE_SEARCH_STATS.
+//   Ticks are TSC cycles on x86 and nanoseconds elsewhere. Hardware counters of the
+//   phases are only read with YNGINE_SEARCH_PERF_COUNTERS, as reading them is a system call
+struct SearchStats {
+    uint64_t phase_ticks[SEARCH_PHASE_COUNT];
+    uint64_t phase_calls[SEARCH_PHASE_COUNT];
+    PerfCounterValues phase_counters[SEARCH_PHASE_COUNT];
+    uint64_t events[SEARCH_EVENT_COUNT];
+
+    void merge(const SearchStats& other);
+
+    static const char* phase_name(SearchPhase phase);
+    static const char* event_name(SearchEvent event);
+};
+
+#ifdef YNGINE_SEARCH_STATS
+inline thread_local SearchStats thread_search_stats{};
+#endif
+
+#ifdef YNGINE_SEARCH_PERF_COUNTERS
+inline thread_local PerfCounterGroup thread_perf_counters;
+inline thread_local PerfCounterValues thread_phase_start_counters{};
+#endif
+
+// Statistics of the calling thread, which the search merges into its tree at the end of
+//   every slice. Without YNGINE_SEARCH_STATS all of it is empty and compiles to nothing
+class ThreadSearchStats {
+public:
+    static uint64_t read_ticks() {
+#ifdef YNGINE_SEARCH_STATS
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+#endif
+#else
+        return 0;
+#endif
+    }
+
+    // Returns the start of the first phase of an iteration
+    static uint64_t begin_phase() {
+#ifdef YNGINE_SEARCH_PERF_COUNTERS
+        thread_phase_start_counters = thread_perf_counters.read();
+#endif
+        return ThreadSearchStats::read_ticks();
+    }
+
+    // Returns the end of the phase, which is the start of the next one
+    static uint64_t end_phase([[maybe_unused]] SearchPhase phase, [[maybe_unused]] uint64_t start_ticks) {
+#ifdef YNGINE_SEARCH_STATS
+        const uint64_t end_ticks = ThreadSearchStats::read_ticks();
+
+        thread_search_stats.phase_ticks[static_cast<std::size_t>(phase)] += end_ticks - start_ticks;
+        thread_search_stats.phase_calls[static_cast<std::size_t>(phase)]++;
+
+#ifdef YNGINE_SEARCH_PERF_COUNTERS
+        const auto end_counters = thread_perf_counters.read();
+        thread_search_stats.phase_counters[static_cast<std::size_t>(phase)] += end_counters - thread_phase_start_counters;
+        thread_phase_start_counters = end_counters;
+
+        // The counters are read outside of the timed phases
+        return ThreadSearchStats::read_ticks();
+#else
+        return end_ticks;
+#endif
+#else
+        return 0;
+#endif
+    }
+
+    static void count([[maybe_unused]] SearchEvent event) {
+#ifdef YNGINE_SEARCH_STATS
+        thread_search_stats.events[static_cast<std::size_t>(event)]++;
+#endif
+    }
+
+    // Returns what was collected since the last call and starts over
+    static SearchStats take() {
+#ifdef YNGINE_SEARCH_STATS
+        const auto stats = thread_search_stats;
+        thread_search_stats = SearchStats{};
+        return stats;
+#else
+        return SearchStats{};
+#endif
+    }
+};
+
+}
+
+#endif // YNGINE_SEARCH_STATS_HPP
@@ -0,0 +1,76 @@
+#include <yngine/symmetry.hpp>
+#include <yngine/tables.hpp>
+
+#include <cassert>
+
+namespace Yngine {
+
+uint8_t transform_index(uint8_t index, uint8_t symmetry) {
+    assert(symmetry < SYMMETRY_COUNT);
+    return TABLE_SYMMETRY_INDICES[symmetry][index];
+}
+
+Direction transform_direction(Direction direction, uint8_t symmetry) {
+    assert(symmetry < SYMMETRY_COUNT);
+    return TABLE_SYMMETRY_DIRECTIONS[symmetry][static_cast<uint8_t>(direction)];
+}
+
+Bitboard transform_bitboard(Bitboard bitboard, uint8_t symmetry) {
+    if (symmetry == SYMMETRY_IDENTITY) {
+        return bitboard;
+    }
+
+    const uint8_t* indices = TABLE_SYMMETRY_INDICES[symmetry];
+
+    Bitboard result{};
+    while (bitboard) {
+        result.set_bit(indices[bitboard.bit_scan_and_reset()]);
+    }
+
+    return result;
+}
+
+Move transform_move(Move move, uint8_t symmetry) {
+    if (symmetry == SYMMETRY_IDENTITY) {
+        return move;
+    }
+
+    return std::visit(variant_overloaded{
+        [symmetry](PlaceRingMove move) -> Move {
+            return PlaceRingMove{transform_index(move.index, symmetry)};
+        },
+        [symmetry](RingMove move) -> Move {
+            return RingMove{
+                transform_index(move.from, symmetry),
+                transform_index(move.to, symmetry),
+                transform_direction(move.direction, symmetry),
+            };
+        },
+        [symmetry](RemoveRowMove move) -> Move {
+            return RemoveRowMove{
+                transform_index(move.from, symmetry),
+                transform_direction(move.direction, symmetry),
+            };
+        },
+        [symmetry](RemoveRingMove move) -> Move {
+            return RemoveRingMove{transform_index(move.index, symmetry)};
+        },
+        [](PassMove move) -> Move {
+            return move;
+        },
+        [symmetry](RemoveRowAndRingMove move) -> Move {
+            return RemoveRowAndRingMove{
+                transform_index(move.from, symmetry),
+                transform_direction(move.direction, symmetry),
+                transform_index(move.ring, symmetry),
+            };
+        },
+    }, move);
+}
+
+uint8_t inverse_symmetry(uint8_t symmetry) {
+    assert(symmetry < SYMMETRY_COUNT);
+    return TABLE_SYMMETRY_INVERSES[symmetry];
+}
+
+}
@@ -0,0 +1,22 @@
+#ifndef YNGINE_SYMMETRY_HPP
+#define YNGINE_SYMMETRY_HPP
+
+#include <yngine/bitboard.hpp>
+#include <yngine/moves.hpp>
+
+namespace Yngine {
+
+// The board has 6 rotations and 6 reflections, symmetry 0 is the identity
+constexpr uint8_t SYMMETRY_COUNT = 12;
+constexpr uint8_t SYMMETRY_IDENTITY = 0;
+
+uint8_t transform_index(uint8_t index, uint8_t symmetry);
+Direction transform_direction(Direction direction, uint8_t symmetry);
+// Only moves the set bits, so it costs a few table lookups per set bit
+Bitboard transform_bitboard(Bitboard bitboard, uint8_t symmetry);
+Move transform_move(Move move, uint8_t symmetry);
+uint8_t inverse_symmetry(uint8_t symmetry);
+
+}
+
+#endif // YNGINE_SYMMETRY_HPP
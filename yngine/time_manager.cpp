@@ -0,0 +1,71 @@
+#include <yngine/time_manager.hpp>
+
+#include <algorithm>
+
+namespace Yngine {
+
+TimeManager::TimeManager(TimeControl time_control)
+    : extensions{0} {
+    const int moves_to_go = time_control.moves_to_go > 0
+        ? time_control.moves_to_go
+        : TimeManager::EXPECTED_MOVES_TO_GO;
+
+    const float target_seconds = time_control.remaining_seconds / moves_to_go
+        + time_control.increment_seconds * 0.75f;
+
+    this->max_seconds = std::min(
+        target_seconds * TimeManager::MAX_TARGET_FACTOR,
+        (time_control.remaining_seconds + time_control.increment_seconds) * TimeManager::MAX_REMAINING_SHARE
+    );
+    this->target_seconds = std::min(target_seconds, this->max_seconds);
+    this->deadline_seconds = this->target_seconds;
+}
+
+float TimeManager::get_target_seconds() const {
+    return this->target_seconds;
+}
+
+float TimeManager::get_max_seconds() const {
+    return this->max_seconds;
+}
+
+float TimeManager::get_deadline_seconds() const {
+    return this->deadline_seconds;
+}
+
+float TimeManager::update(
+    float elapsed_seconds,
+    uint32_t search_iterations,
+    uint32_t root_simulations,
+    uint32_t best_simulations,
+    uint32_t second_simulations
+) {
+    if (search_iterations < TimeManager::MIN_ITERATIONS || elapsed_seconds <= 0.0f) {
+        return this->deadline_seconds;
+    }
+
+    // Even if all remaining iterations went to the second best move it couldn't overtake the best one
+    const float iterations_per_second = search_iterations / elapsed_seconds;
+    const float remaining_iterations = iterations_per_second * std::max(this->deadline_seconds - elapsed_seconds, 0.0f);
+    if (best_simulations - second_simulations > remaining_iterations) {
+        return elapsed_seconds;
+    }
+
+    // Almost all visits go to the best move
+    if (best_simulations >= root_simulations * TimeManager::SETTLED_VISIT_SHARE) {
+        return elapsed_seconds;
+    }
+
+    // The two best moves are close and we are about to stop, spend some more time on them
+    const float extension_seconds = this->target_seconds * TimeManager::EXTENSION_FACTOR;
+    if (this->extensions < TimeManager::MAX_EXTENSIONS
+        && second_simulations >= best_simulations * TimeManager::CLOSE_VISIT_RATIO
+        && this->deadline_seconds - elapsed_seconds < extension_seconds / 2) {
+        this->deadline_seconds = std::min(this->deadline_seconds + extension_seconds, this->max_seconds);
+        this->extensions++;
+    }
+
+    return this->deadline_seconds;
+}
+
+}
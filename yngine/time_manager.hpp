@@ -0,0 +1,62 @@
+#ifndef YNGINE_TIME_MANAGER_HPP
+#define YNGINE_TIME_MANAGER_HPP
+
+#include <cstdint>
+
+namespace Yngine {
+
+// Game clock of the side to move
+struct TimeControl {
+    float remaining_seconds;
+    float increment_seconds = 0.0f;
+    // Zero if the number of moves until the next time control is unknown
+    int moves_to_go = 0;
+};
+
+// Decides how long to search a move for. The search gets a target time from the
+//   clock, it's stopped early once the best move is settled and extended up to
+//   the maximum time when the two best moves are close
+class TimeManager {
+public:
+    // Moves we expect to still play when the number of moves to go is unknown
+    static constexpr int EXPECTED_MOVES_TO_GO = 30;
+    // Parts of the clock a single search can use at most
+    static constexpr float MAX_TARGET_FACTOR = 3.0f;
+    static constexpr float MAX_REMAINING_SHARE = 0.25f;
+    // Part of the root visits after which the best move is considered settled
+    static constexpr float SETTLED_VISIT_SHARE = 0.9f;
+    // The two best moves are close if the second one has this part of the visits of the best one
+    static constexpr float CLOSE_VISIT_RATIO = 0.8f;
+    // Part of the target time added with each extension
+    static constexpr float EXTENSION_FACTOR = 0.5f;
+    static constexpr int MAX_EXTENSIONS = 2;
+    // The statistics are too noisy to decide anything before this many iterations
+    static constexpr uint32_t MIN_ITERATIONS = 256;
+
+    TimeManager(TimeControl time_control);
+
+    float get_target_seconds() const;
+    float get_max_seconds() const;
+    float get_deadline_seconds() const;
+
+    // Takes the statistics of the root and returns the time from the start of the
+    //   search at which it should stop, which is not later than elapsed time if
+    //   the search should stop right away
+    float update(
+        float elapsed_seconds,
+        uint32_t search_iterations,
+        uint32_t root_simulations,
+        uint32_t best_simulations,
+        uint32_t second_simulations
+    );
+
+private:
+    float target_seconds;
+    float max_seconds;
+    float deadline_seconds;
+    int extensions;
+};
+
+}
+
+#endif // YNGINE_TIME_MANAGER_HPP
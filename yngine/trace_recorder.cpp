@@ -0,0 +1,146 @@
+#include <yngine/trace_recorder.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <iomanip>
+
+namespace Yngine {
+
+static std::atomic<uint64_t> next_recorder_id{1};
+
+TraceRecorder::TraceRecorder(std::size_t events_per_thread)
+    : id{next_recorder_id.fetch_add(1)}
+    , events_mask{std::bit_ceil(std::max<std::size_t>(events_per_thread, 1)) - 1}
+    , start{std::chrono::steady_clock::now()} {
+}
+
+uint64_t TraceRecorder::now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start).count();
+}
+
+void TraceRecorder::instant(const char* name, uint64_t count) {
+    this->record(Event{
+        .name = name,
+        .start_time = this->now(),
+        .duration = 0,
+        .count = count,
+        .is_instant = true,
+    });
+}
+
+void TraceRecorder::complete(const char* name, uint64_t start_time, uint64_t count) {
+    this->record(Event{
+        .name = name,
+        .start_time = start_time,
+        .duration = this->now() - start_time,
+        .count = count,
+        .is_instant = false,
+    });
+}
+
+void TraceRecorder::record(Event event) {
+    ThreadBuffer& buffer = this->get_thread_buffer();
+
+    // Only this thread writes the buffer, the release publishes the event to write_json
+    const uint64_t written = buffer.written.load(std::memory_order_relaxed);
+    buffer.events[written & this->events_mask] = event;
+    buffer.written.store(written + 1, std::memory_order_release);
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::get_thread_buffer() {
+    thread_local uint64_t cached_recorder_id = 0;
+    thread_local ThreadBuffer* cached_buffer = nullptr;
+
+    if (cached_recorder_id == this->id) {
+        return *cached_buffer;
+    }
+
+    std::unique_lock lock{this->thread_buffers_mutex};
+
+    // The thread might have recorded into another recorder since its last event here
+    const auto thread_id = std::this_thread::get_id();
+    auto found = std::find_if(this->thread_buffers.begin(), this->thread_buffers.end(), [&](const auto& buffer) {
+        return buffer->thread_id == thread_id;
+    });
+
+    if (found == this->thread_buffers.end()) {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->thread_id = thread_id;
+        buffer->thread_index = this->thread_buffers.size();
+        buffer->events = std::make_unique<Event[]>(this->events_mask + 1);
+        buffer->written.store(0);
+
+        this->thread_buffers.push_back(std::move(buffer));
+        found = this->thread_buffers.end() - 1;
+    }
+
+    cached_recorder_id = this->id;
+    cached_buffer = found->get();
+
+    return *cached_buffer;
+}
+
+bool TraceRecorder::write_json(const std::string& file_path) const {
+    std::ofstream output{file_path};
+    if (!output) {
+        return false;
+    }
+
+    std::unique_lock lock{this->thread_buffers_mutex};
+
+    // Timestamps of trace events are in microseconds
+    output << std::fixed << std::setprecision(3);
+    output << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+
+    bool is_first = true;
+    const auto separator = [&] {
+        output << (is_first ? "  " : ",\n  ");
+        is_first = false;
+    };
+
+    for (const auto& buffer : this->thread_buffers) {
+        const uint32_t tid = buffer->thread_index + 1;
+
+        separator();
+        output
+            << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << tid
+            << ", \"args\": {\"name\": \"thread " << tid << "\"}}";
+
+        const uint64_t written = buffer->written.load(std::memory_order_acquire);
+        const uint64_t kept = std::min<uint64_t>(written, this->events_mask + 1);
+
+        for (uint64_t event_index = written - kept; event_index < written; event_index++) {
+            const Event& event = buffer->events[event_index & this->events_mask];
+
+            separator();
+            output
+                << "{\"name\": \"" << event.name << "\""
+                << ", \"ph\": \"" << (event.is_instant ? "i" : "X") << "\""
+                << ", \"pid\": 1, \"tid\": " << tid
+                << ", \"ts\": " << event.start_time / 1000.0;
+
+            if (event.is_instant) {
+                output << ", \"s\": \"t\"";
+            } else {
+                output << ", \"dur\": " << event.duration / 1000.0;
+            }
+
+            output << ", \"args\": {\"count\": " << event.count << "}}";
+        }
+    }
+
+    output << "\n]}" << std::endl;
+
+    return output.good();
+}
+
+void TraceRecorder::clear() {
+    std::unique_lock lock{this->thread_buffers_mutex};
+
+    for (auto& buffer : this->thread_buffers) {
+        buffer->written.store(0, std::memory_order_relaxed);
+    }
+}
+
+}
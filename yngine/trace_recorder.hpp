@@ -0,0 +1,74 @@
+#ifndef YNGINE_TRACE_RECORDER_HPP
+#define YNGINE_TRACE_RECORDER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Yngine {
+
+// Records a timeline of events for chrome://tracing or ui.perfetto.dev. Every thread writes
+//   into its own ring buffer without locks, so when a buffer is full the oldest events of
+//   that thread are overwritten. Only the first event of a thread takes a lock
+class TraceRecorder {
+public:
+    static constexpr std::size_t DEFAULT_EVENTS_PER_THREAD = 1 << 16;
+
+    // The number of events per thread is rounded up to a power of two
+    TraceRecorder(std::size_t events_per_thread = DEFAULT_EVENTS_PER_THREAD);
+
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder(TraceRecorder &&) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(TraceRecorder &&) = delete;
+
+    // Nanoseconds since the recorder was created
+    uint64_t now() const;
+
+    // Names are kept as pointers, so they have to be string literals
+    void instant(const char* name, uint64_t count = 0);
+    // Records an event which lasted from the start time until now
+    void complete(const char* name, uint64_t start_time, uint64_t count = 0);
+
+    // Writes the events of all threads as trace event JSON, no thread should be
+    //   recording meanwhile. Returns false if the file couldn't be written
+    bool write_json(const std::string& file_path) const;
+    void clear();
+
+private:
+    struct Event {
+        const char* name;
+        uint64_t start_time;
+        uint64_t duration;
+        uint64_t count;
+        bool is_instant;
+    };
+
+    struct ThreadBuffer {
+        std::thread::id thread_id;
+        uint32_t thread_index;
+        std::unique_ptr<Event[]> events;
+        // Number of events ever written, the last ones are in the buffer
+        std::atomic<uint64_t> written;
+    };
+
+    void record(Event event);
+    ThreadBuffer& get_thread_buffer();
+
+    // Threads remember their buffer by the id, which isn't reused like an address could be
+    const uint64_t id;
+    const std::size_t events_mask;
+    const std::chrono::steady_clock::time_point start;
+
+    std::vector<std::unique_ptr<ThreadBuffer>> thread_buffers;
+    mutable std::mutex thread_buffers_mutex;
+};
+
+}
+
+#endif // YNGINE_TRACE_RECORDER_HPP